@@ -0,0 +1,119 @@
+#include "Api/Parser/JsonParser.hpp"
+#include "Core/BoardManager.hpp"
+#include "Repository/RepositoryIf.hpp"
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <string>
+
+using namespace Prog3::Core;
+using namespace Prog3::Core::Model;
+using namespace Prog3::Api::Parser;
+using namespace Prog3::Repository;
+
+namespace {
+
+// In memory board, so the numbers show what BoardManager and the parser cost
+// per request and not what sqlite costs.
+class StubRepository final : public RepositoryIf {
+  private:
+    std::vector<Column> columns;
+
+  public:
+    StubRepository(int itemsPerColumn) {
+        for (int c = 1; c <= 3; c++) {
+            Column column(c, "column " + std::to_string(c), c);
+            for (int i = 1; i <= itemsPerColumn; i++) {
+                Item item(c * 1000 + i, "item " + std::to_string(i), i, 1704067200);
+                column.addItem(item);
+            }
+            columns.push_back(column);
+        }
+    }
+
+    Board getBoard() override {
+        Board board("Kanban Board");
+        board.setColumns(columns);
+        return board;
+    }
+    std::vector<Column> getColumns() override { return columns; }
+    std::optional<Column> getColumn(std::int64_t) override { return columns.at(0); }
+    std::optional<Column> postColumn(std::string name, int position) override { return Column(4, name, position); }
+    std::optional<Column> putColumn(std::int64_t id, std::string name, int position) override { return Column(id, name, position); }
+    void deleteColumn(std::int64_t) override {}
+    std::vector<Item> getItems(std::int64_t) override { return columns.at(0).getItems(); }
+    std::optional<Item> getItem(std::int64_t, std::int64_t itemId) override { return Item(itemId, "item", 1, 1704067200); }
+    std::optional<Item> postItem(std::int64_t, std::string title, int position) override { return Item(1, title, position, 1704067200); }
+    std::optional<Item> putItem(std::int64_t, std::int64_t itemId, std::string title, int position) override { return Item(itemId, title, position, 1704067200); }
+    void deleteItem(std::int64_t, std::int64_t) override {}
+
+    std::int64_t getVersion() override { return 0; }
+    std::int64_t peekVersion() override { return 0; }
+    std::optional<ChangeSet> getChangesSince(std::int64_t version) override { return ChangeSet(version); }
+
+    std::vector<SearchHit> searchItems(std::string, int, int) override { return {}; }
+    std::vector<ArchivedItem> getArchivedItems(int, int) override { return {}; }
+};
+
+std::size_t sink = 0;
+
+void measure(char const *name, int iterations, std::function<void()> const &warmup, std::function<std::size_t()> const &request) {
+    warmup();
+
+    auto started = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        sink += request();
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - started;
+
+    std::printf("%-36s %10.1f ns/request\n", name, elapsed.count() / iterations);
+}
+
+template <typename Manager>
+void run(char const *form, Manager &manager, int iterations) {
+    std::string postItemRequest = "{\"title\":\"benchmark\",\"position\":1}";
+    std::string label;
+    auto noop = []() {};
+
+    label = std::string(form) + " deleteItem";
+    measure(label.c_str(), iterations, noop, [&manager]() {
+        manager.deleteItem(1, 1);
+        return std::size_t(1);
+    });
+
+    label = std::string(form) + " getItem";
+    measure(label.c_str(), iterations, noop, [&manager]() {
+        return manager.getItem(1, 1).size();
+    });
+
+    label = std::string(form) + " postItem";
+    measure(label.c_str(), iterations, noop, [&manager, &postItemRequest]() {
+        return manager.postItem(1, postItemRequest).size();
+    });
+
+    label = std::string(form) + " getBoard";
+    measure(label.c_str(), iterations / 20, noop, [&manager]() {
+        return manager.getBoard().size();
+    });
+}
+
+} // namespace
+
+// Per request overhead of BoardManager with virtual dispatch through
+// ParserIf/RepositoryIf against the statically dispatched production form.
+int main(int argc, char **argv) {
+    int iterations = (argc > 1) ? std::stoi(argv[1]) : 200000;
+
+    JsonParser parser;
+    StubRepository repository(20);
+
+    InterfaceBoardManager interfaceManager(parser, repository);
+    BasicBoardManager<JsonParser, StubRepository> staticManager(parser, repository);
+
+    for (int round = 0; round < 2; round++) {
+        run("interface", interfaceManager, iterations);
+        run("static", staticManager, iterations);
+    }
+
+    return sink == 0;
+}
@@ -0,0 +1,538 @@
+#include "Api/Endpoint.hpp"
+#include "Api/Parser/JsonParser.hpp"
+#include "Api/RequestDriver.hpp"
+#include "Core/Admission/AdmissionController.hpp"
+#include "Core/BoardDirectory.hpp"
+#include "Core/BoardManager.hpp"
+#include "Core/Metrics/MetricsRegistry.hpp"
+#include "Repository/SQLite/BoardRepository.hpp"
+#include "Repository/SQLite/BulkLoader.hpp"
+#include "rapidjson/document.h"
+#include "rapidjson/istreamwrapper.h"
+#include "rapidjson/prettywriter.h"
+#include "rapidjson/stringbuffer.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+using namespace Prog3::Api;
+using namespace Prog3::Core;
+using namespace Prog3::Core::Model;
+using namespace Prog3::Api::Parser;
+using namespace Prog3::Repository::SQLite;
+
+namespace {
+
+struct BoardSize {
+    int columns;
+    int itemsPerColumn;
+
+    std::string getLabel() const {
+        return std::to_string(columns) + "x" + std::to_string(itemsPerColumn);
+    }
+};
+
+struct Options {
+    std::vector<BoardSize> sizes = {{4, 10}, {8, 100}, {8, 1000}};
+    // boards made by DatasetGenerator, run on a copy instead of the sizes
+    std::vector<std::string> databases;
+    std::chrono::milliseconds sampleTime{50};
+    int samples = 5;
+    std::string filter;
+    std::string jsonFile;
+};
+
+struct Result {
+    std::string group;
+    std::string name;
+    std::string size;
+    double nsPerOp;
+    double minNsPerOp;
+    std::uint64_t iterations;
+
+    std::string getKey() const {
+        return group + " " + name + " " + size;
+    }
+};
+
+std::size_t sink = 0;
+
+// Times op(i) in batches of one sample time each and keeps the median and the
+// best batch. The batch size doubles until a batch takes a whole sample time.
+class Suite {
+  public:
+    Suite(Options const &givenOptions) : options(givenOptions) {}
+
+    bool isSelected(std::string const &group, std::string const &name) const {
+        return options.filter.empty() || (group + "/" + name).find(options.filter) != std::string::npos;
+    }
+
+    void run(std::string const &group, std::string const &name, std::string const &size,
+             std::function<std::size_t(std::uint64_t)> const &op) {
+        if (!isSelected(group, name)) {
+            return;
+        }
+
+        std::uint64_t next = 0;
+        sink += op(next++);
+
+        std::uint64_t batch = 1;
+        while (true) {
+            double elapsed = time(batch, next, op);
+            if (elapsed >= std::chrono::duration<double, std::nano>(options.sampleTime).count() || batch >= (1u << 30)) {
+                break;
+            }
+            batch *= 2;
+        }
+
+        std::vector<double> perOp;
+        for (int sample = 0; sample < options.samples; sample++) {
+            perOp.push_back(time(batch, next, op) / batch);
+        }
+
+        record(group, name, size, perOp, batch * options.samples);
+    }
+
+    // a single pass over count operations, for work that can only be done a given number of times
+    void runOnce(std::string const &group, std::string const &name, std::string const &size, std::uint64_t count,
+                 std::function<std::size_t(std::uint64_t)> const &op) {
+        if (!isSelected(group, name) || count == 0) {
+            return;
+        }
+
+        std::uint64_t next = 0;
+        record(group, name, size, {time(count, next, op) / count}, count);
+    }
+
+    std::vector<Result> const &getResults() const {
+        return results;
+    }
+
+  private:
+    Options const &options;
+    std::vector<Result> results;
+
+    static double time(std::uint64_t count, std::uint64_t &next, std::function<std::size_t(std::uint64_t)> const &op) {
+        auto started = std::chrono::steady_clock::now();
+        for (std::uint64_t i = 0; i < count; i++) {
+            sink += op(next++);
+        }
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - started).count();
+    }
+
+    void record(std::string const &group, std::string const &name, std::string const &size, std::vector<double> perOp,
+                std::uint64_t iterations) {
+        std::sort(perOp.begin(), perOp.end());
+        Result result{group, name, size, perOp[perOp.size() / 2], perOp.front(), iterations};
+        results.push_back(result);
+
+        std::printf("%-10s %-36s %-8s %14.1f ns/op %14.1f min %10llu iterations\n", group.c_str(), name.c_str(), size.c_str(),
+                    result.nsPerOp, result.minNsPerOp, static_cast<unsigned long long>(iterations));
+        std::fflush(stdout);
+    }
+};
+
+void fillBoard(std::string const &databaseFile, BoardSize const &size) {
+    BulkLoader loader(databaseFile);
+    std::int64_t now = std::time(nullptr);
+
+    for (int c = 1; c <= size.columns; c++) {
+        loader.addColumn(c, "column " + std::to_string(c), c);
+        for (int i = 1; i <= size.itemsPerColumn; i++) {
+            loader.addItem(c, "task " + std::to_string(c) + "." + std::to_string(i) + " review the pull request", i, now, now);
+        }
+    }
+
+    loader.finish();
+}
+
+// the item in the middle of the middle column, reads and writes go there
+struct Target {
+    std::int64_t columnId;
+    std::int64_t itemId;
+    int position;
+
+    static Target find(BoardRepository &repository) {
+        std::vector<Column> columns = repository.getColumns();
+        Column const &column = columns.at(columns.size() / 2);
+        Item const &item = column.getItems().at(column.getItems().size() / 2);
+
+        return Target{column.getId(), item.getId(), item.getPos()};
+    }
+};
+
+void runRepository(Suite &suite, BoardRepository &repository, std::string const &label) {
+    Target target = Target::find(repository);
+    std::int64_t columnId = target.columnId;
+    std::int64_t itemId = target.itemId;
+    int nextPosition = 1000000000;
+
+    suite.run("repository", "getBoard", label, [&](std::uint64_t) { return repository.getBoard().getColumns().size(); });
+    suite.run("repository", "getColumns", label, [&](std::uint64_t) { return repository.getColumns().size(); });
+    suite.run("repository", "getColumn", label, [&](std::uint64_t) { return repository.getColumn(columnId)->getItems().size(); });
+    suite.run("repository", "getItems", label, [&](std::uint64_t) { return repository.getItems(columnId).size(); });
+    suite.run("repository", "getItem", label, [&](std::uint64_t) { return repository.getItem(columnId, itemId)->getTitle().size(); });
+    suite.run("repository", "peekVersion", label, [&](std::uint64_t) { return std::size_t(repository.peekVersion()); });
+    suite.run("repository", "getVersion", label, [&](std::uint64_t) { return std::size_t(repository.getVersion()); });
+    suite.run("repository", "getChangesSince", label, [&](std::uint64_t) {
+        return repository.getChangesSince(repository.getVersion() - 10)->getChanges().size();
+    });
+    suite.run("repository", "searchItems", label, [&](std::uint64_t) { return repository.searchItems("review", 20, 0).size(); });
+
+    suite.run("repository", "putItem", label, [&](std::uint64_t i) {
+        return repository.putItem(columnId, itemId, "renamed " + std::to_string(i), target.position)->getTitle().size();
+    });
+    suite.run("repository", "putColumn", label, [&](std::uint64_t i) {
+        return repository.putColumn(columnId, "column " + std::to_string(i), static_cast<int>(columnId))->getName().size();
+    });
+
+    // deleteItem removes exactly the items postItem added
+    std::vector<std::int64_t> posted;
+    suite.run("repository", "postItem", label, [&](std::uint64_t) {
+        auto item = repository.postItem(columnId, "posted", nextPosition++);
+        posted.push_back(item->getId());
+        return std::size_t(1);
+    });
+    suite.runOnce("repository", "deleteItem", label, posted.size(), [&](std::uint64_t i) {
+        repository.deleteItem(columnId, posted[i]);
+        return std::size_t(1);
+    });
+}
+
+void runManager(Suite &suite, BoardManager &manager, BoardRepository &repository, std::string const &label) {
+    Target target = Target::find(repository);
+    std::int64_t columnId = target.columnId;
+    std::int64_t itemId = target.itemId;
+    int nextPosition = 1100000000;
+
+    suite.run("manager", "getBoard", label, [&](std::uint64_t) { return manager.getBoard().size(); });
+    suite.run("manager", "getColumns", label, [&](std::uint64_t) { return manager.getColumns().size(); });
+    suite.run("manager", "getColumn", label, [&](std::uint64_t) { return manager.getColumn(columnId).size(); });
+    suite.run("manager", "getItems", label, [&](std::uint64_t) { return manager.getItems(columnId).size(); });
+    suite.run("manager", "getItem", label, [&](std::uint64_t) { return manager.getItem(columnId, itemId).size(); });
+    suite.run("manager", "getChanges", label, [&](std::uint64_t) { return manager.getChanges(repository.getVersion() - 10).size(); });
+    suite.run("manager", "searchItems", label, [&](std::uint64_t) { return manager.searchItems("review", 20, 0).size(); });
+
+    // writes replace the snapshot, copy on write for the touched column
+    suite.run("manager", "putItem", label, [&](std::uint64_t i) {
+        std::string request = "{\"title\":\"renamed " + std::to_string(i) + "\",\"position\":" + std::to_string(target.position) + "}";
+        return manager.putItem(columnId, itemId, request).size();
+    });
+    // a write followed by the read that finds the snapshot out of date
+    suite.run("manager", "putItem+getBoard", label, [&](std::uint64_t i) {
+        repository.putItem(columnId, itemId, "again " + std::to_string(i), target.position);
+        return manager.getBoard().size();
+    });
+
+    std::vector<std::int64_t> posted;
+    suite.run("manager", "postItem", label, [&](std::uint64_t) {
+        std::string request = "{\"title\":\"posted\",\"position\":" + std::to_string(nextPosition++) + "}";
+        std::string response = manager.postItem(columnId, request);
+        rapidjson::Document document;
+        document.Parse(response.c_str());
+        posted.push_back(document["id"].GetInt64());
+        return response.size();
+    });
+    suite.runOnce("manager", "deleteItem", label, posted.size(), [&](std::uint64_t i) {
+        manager.deleteItem(columnId, posted[i]);
+        return std::size_t(1);
+    });
+}
+
+// the whole route: router, admission, deadline, arena, handler and manager, as
+// a request from a connection would run it but without the socket and parsing
+void runEndpoint(Suite &suite, JsonParser &parser, BoardRepository &repository, std::string const &label) {
+    Target target = Target::find(repository);
+    int nextPosition = 1200000000;
+
+    crow::SimpleApp app;
+    Metrics::MetricsRegistry metrics;
+    BoardDirectory boardDirectory(parser, [&repository](int, bool) -> BoardManager::RepositoryType * { return &repository; });
+    Admission::AdmissionController admissionController(metrics, Admission::AdmissionOptions());
+    Endpoint endpoint(app, boardDirectory, admissionController, DeadlineOptions());
+    RequestDriver driver(app);
+
+    std::string column = "/api/board/columns/" + std::to_string(target.columnId);
+    std::string item = column + "/items/" + std::to_string(target.itemId);
+
+    // a route that answers otherwise would time the error path instead
+    auto check = [](crow::response const &res, std::string const &name, int expectedCode = 200) {
+        if (res.code != expectedCode) {
+            std::cerr << "endpoint " << name << " answered " << res.code << std::endl;
+        }
+        return res.body.size();
+    };
+
+    suite.run("endpoint", "GET board", label, [&](std::uint64_t) { return check(driver.get("/api/board"), "GET board"); });
+    suite.run("endpoint", "GET column", label, [&](std::uint64_t) { return check(driver.get(column), "GET column"); });
+    suite.run("endpoint", "GET item", label, [&](std::uint64_t) { return check(driver.get(item), "GET item"); });
+    suite.run("endpoint", "GET search", label, [&](std::uint64_t) {
+        return check(driver.get("/api/board/search?q=review&limit=20"), "GET search");
+    });
+    suite.run("endpoint", "PUT item", label, [&](std::uint64_t i) {
+        std::string request = "{\"title\":\"renamed " + std::to_string(i) + "\",\"position\":" + std::to_string(target.position) + "}";
+        return check(driver.put(item, request), "PUT item");
+    });
+
+    std::vector<std::string> posted;
+    suite.run("endpoint", "POST item", label, [&](std::uint64_t) {
+        std::string request = "{\"title\":\"posted\",\"position\":" + std::to_string(nextPosition++) + "}";
+        crow::response res = driver.post(column + "/items", request);
+        rapidjson::Document document;
+        document.Parse(res.body.c_str());
+        if (document.IsObject() && document.HasMember("id")) {
+            posted.push_back(column + "/items/" + std::to_string(document["id"].GetInt64()));
+        }
+        return check(res, "POST item", 201);
+    });
+    suite.runOnce("endpoint", "DELETE item", label, posted.size(), [&](std::uint64_t i) {
+        return check(driver.remove(posted[i]), "DELETE item");
+    });
+}
+
+void runParser(Suite &suite, JsonParser &parser, BoardRepository &repository, std::string const &label) {
+
+    Board board = repository.getBoard();
+    std::vector<Column> columns = board.getColumns();
+    Column const &column = columns.at(columns.size() / 2);
+    std::vector<Item> const &items = column.getItems();
+    Item const &item = items.at(items.size() / 2);
+
+    ChangeSet changes(items.size());
+    std::vector<SearchHit> hits;
+    std::vector<ArchivedItem> archivedItems;
+    std::int64_t sequence = 0;
+    for (auto const &columnItem : items) {
+        Change change(++sequence, Change::Entity::Item, Change::Operation::Update, columnItem.getId(), column.getId());
+        change.setItem(columnItem);
+        changes.addChange(change);
+        hits.emplace_back(column.getId(), columnItem);
+        archivedItems.emplace_back(columnItem, column.getId(), column.getName(), columnItem.getTimestamp());
+    }
+
+    ParserIf::ColumnFragments fragments;
+    for (auto const &boardColumn : columns) {
+        fragments.push_back(std::make_shared<std::string const>(parser.convertToApiString(boardColumn)));
+    }
+
+    std::string columnRequest = "{\"name\":\"benchmark\",\"position\":1}";
+    std::string itemRequest = "{\"title\":\"benchmark item with a title\",\"position\":1}";
+
+    suite.run("parser", "convertToApiString(Board)", label, [&](std::uint64_t) { return parser.convertToApiString(board).size(); });
+    suite.run("parser", "convertToApiString(Board, version)", label, [&](std::uint64_t) { return parser.convertToApiString(board, 42).size(); });
+    suite.run("parser", "convertToApiString(Column)", label, [&](std::uint64_t) { return parser.convertToApiString(column).size(); });
+    suite.run("parser", "convertToApiString(Columns)", label, [&](std::uint64_t) { return parser.convertToApiString(columns).size(); });
+    suite.run("parser", "convertToApiString(Item)", label, [&](std::uint64_t) { return parser.convertToApiString(item).size(); });
+    suite.run("parser", "convertToApiString(Items)", label, [&](std::uint64_t) { return parser.convertToApiString(items).size(); });
+    suite.run("parser", "convertToApiString(ChangeSet)", label, [&](std::uint64_t) { return parser.convertToApiString(changes).size(); });
+    suite.run("parser", "convertToApiString(SearchHits)", label, [&](std::uint64_t) { return parser.convertToApiString(hits).size(); });
+    suite.run("parser", "convertToApiString(ArchivedItems)", label, [&](std::uint64_t) { return parser.convertToApiString(archivedItems).size(); });
+    suite.run("parser", "assembleBoardApiString", label, [&](std::uint64_t) { return parser.assembleBoardApiString(board.getTitle(), fragments).size(); });
+    suite.run("parser", "assembleColumnsApiString", label, [&](std::uint64_t) { return parser.assembleColumnsApiString(fragments).size(); });
+    suite.run("parser", "convertColumnToModel", label, [&](std::uint64_t) { return parser.convertColumnToModel(1, columnRequest)->getName().size(); });
+    suite.run("parser", "convertItemToModel", label, [&](std::uint64_t) { return parser.convertItemToModel(1, itemRequest)->getTitle().size(); });
+}
+
+void writeResults(std::string const &file, std::vector<Result> const &results) {
+    rapidjson::StringBuffer buffer;
+    rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(buffer);
+
+    writer.StartObject();
+    writer.Key("benchmarks");
+    writer.StartArray();
+    for (auto const &result : results) {
+        writer.StartObject();
+        writer.Key("group");
+        writer.String(result.group.c_str());
+        writer.Key("name");
+        writer.String(result.name.c_str());
+        writer.Key("size");
+        writer.String(result.size.c_str());
+        writer.Key("nsPerOp");
+        writer.Double(result.nsPerOp);
+        writer.Key("minNsPerOp");
+        writer.Double(result.minNsPerOp);
+        writer.Key("iterations");
+        writer.Uint64(result.iterations);
+        writer.EndObject();
+    }
+    writer.EndArray();
+    writer.EndObject();
+
+    std::ofstream(file) << buffer.GetString() << std::endl;
+}
+
+std::map<std::string, Result> readResults(std::string const &file) {
+    std::ifstream stream(file);
+    rapidjson::IStreamWrapper wrapper(stream);
+    rapidjson::Document document;
+    document.ParseStream(wrapper);
+
+    std::map<std::string, Result> results;
+    if (document.HasParseError() || !document.IsObject() || !document.HasMember("benchmarks")) {
+        std::cerr << "cannot read " << file << std::endl;
+        return results;
+    }
+
+    for (auto const &entry : document["benchmarks"].GetArray()) {
+        Result result{entry["group"].GetString(), entry["name"].GetString(), entry["size"].GetString(),
+                      entry["nsPerOp"].GetDouble(), entry["minNsPerOp"].GetDouble(), entry["iterations"].GetUint64()};
+        results.emplace(result.getKey(), result);
+    }
+
+    return results;
+}
+
+// prints the change from base to current per benchmark, 1 if one got slower by more than threshold percent
+int compare(std::string const &baseFile, std::string const &currentFile, double threshold) {
+    auto base = readResults(baseFile);
+    auto current = readResults(currentFile);
+    if (base.empty() || current.empty()) {
+        return 2;
+    }
+
+    int slower = 0;
+    std::printf("%-10s %-36s %-8s %14s %14s %9s\n", "group", "name", "size", "base ns/op", "ns/op", "change");
+    for (auto const &[key, result] : current) {
+        auto found = base.find(key);
+        if (found == base.end()) {
+            std::printf("%-10s %-36s %-8s %14s %14.1f %9s\n", result.group.c_str(), result.name.c_str(), result.size.c_str(), "-",
+                        result.nsPerOp, "new");
+            continue;
+        }
+
+        double change = (result.nsPerOp / found->second.nsPerOp - 1) * 100;
+        char const *mark = "";
+        if (change > threshold) {
+            mark = "  slower";
+            slower++;
+        } else if (change < -threshold) {
+            mark = "  faster";
+        }
+
+        std::printf("%-10s %-36s %-8s %14.1f %14.1f %+8.1f%%%s\n", result.group.c_str(), result.name.c_str(), result.size.c_str(),
+                    found->second.nsPerOp, result.nsPerOp, change, mark);
+    }
+
+    std::printf("%d of %zu benchmarks slower by more than %.1f%%\n", slower, current.size(), threshold);
+    return slower > 0 ? 1 : 0;
+}
+
+std::vector<BoardSize> parseSizes(std::string const &value) {
+    std::vector<BoardSize> sizes;
+    std::istringstream list(value);
+    std::string size;
+
+    while (std::getline(list, size, ',')) {
+        std::size_t separator = size.find('x');
+        if (separator != std::string::npos) {
+            sizes.push_back({std::max(1, std::stoi(size.substr(0, separator))), std::max(1, std::stoi(size.substr(separator + 1)))});
+        }
+    }
+
+    return sizes;
+}
+
+void printUsage() {
+    std::cerr << "usage: HotPathBenchmark [--sizes 4x10,8x100,8x1000 | --database file.db ...] [--sample-ms 50] [--samples 5]\n"
+                 "                        [--filter text] [--json file]\n"
+                 "       HotPathBenchmark --compare base.json current.json [--threshold 5]\n";
+}
+
+} // namespace
+
+// Repository, BoardManager, JsonParser and route hot paths in process, on sqlite
+// boards of the given sizes (columns x items per column) or on copies of
+// boards made by DatasetGenerator.
+int main(int argc, char **argv) {
+    Options options;
+    double threshold = 5;
+    std::vector<std::string> compareFiles;
+
+    for (int i = 1; i < argc; i++) {
+        std::string name = argv[i];
+        if (name == "--compare" && i + 2 < argc) {
+            compareFiles = {argv[i + 1], argv[i + 2]};
+            i += 2;
+        } else if (i + 1 >= argc) {
+            printUsage();
+            return 2;
+        } else if (name == "--sizes") {
+            options.sizes = parseSizes(argv[++i]);
+        } else if (name == "--sample-ms") {
+            options.sampleTime = std::chrono::milliseconds(std::stoi(argv[++i]));
+        } else if (name == "--samples") {
+            options.samples = std::max(1, std::stoi(argv[++i]));
+        } else if (name == "--database") {
+            options.databases.push_back(argv[++i]);
+        } else if (name == "--filter") {
+            options.filter = argv[++i];
+        } else if (name == "--json") {
+            options.jsonFile = argv[++i];
+        } else if (name == "--threshold") {
+            threshold = std::stod(argv[++i]);
+        } else {
+            printUsage();
+            return 2;
+        }
+    }
+
+    if (!compareFiles.empty()) {
+        return compare(compareFiles[0], compareFiles[1], threshold);
+    }
+
+    std::filesystem::path directory = std::filesystem::temp_directory_path() / ("kanban-hotpath-" + std::to_string(getpid()));
+    std::filesystem::create_directories(directory);
+
+    Suite suite(options);
+    JsonParser parser;
+    crow::logger::setLogLevel(crow::LogLevel::Warning);
+
+    // label and file of every board to run on
+    std::vector<std::pair<std::string, std::string>> boards;
+    if (options.databases.empty()) {
+        for (auto const &size : options.sizes) {
+            std::string databaseFile = (directory / ("board-" + size.getLabel() + ".db")).string();
+            fillBoard(databaseFile, size);
+            boards.emplace_back(size.getLabel(), databaseFile);
+        }
+    } else {
+        for (auto const &database : options.databases) {
+            std::filesystem::path source(database);
+            std::string databaseFile = (directory / source.filename()).string();
+            std::filesystem::copy_file(source, databaseFile);
+            boards.emplace_back(source.stem().string(), databaseFile);
+        }
+    }
+
+    for (auto const &[label, databaseFile] : boards) {
+        BoardRepository repository(databaseFile, "Benchmark Board");
+        BoardManager manager(parser, repository);
+
+        runParser(suite, parser, repository, label);
+        runRepository(suite, repository, label);
+        runManager(suite, manager, repository, label);
+        runEndpoint(suite, parser, repository, label);
+
+        std::filesystem::remove(databaseFile);
+    }
+
+    std::filesystem::remove_all(directory);
+
+    if (!options.jsonFile.empty()) {
+        writeResults(options.jsonFile, suite.getResults());
+    }
+
+    return sink == 0;
+}
@@ -0,0 +1,157 @@
+#include "Api/Parser/JsonParser.hpp"
+#include "Core/Model/Timestamp.hpp"
+#include "Core/RequestContext.hpp"
+#include "rapidjson/stringbuffer.h"
+#include "rapidjson/writer.h"
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <new>
+#include <string>
+
+using namespace Prog3::Core;
+using namespace Prog3::Core::Model;
+using namespace Prog3::Api::Parser;
+
+namespace {
+
+std::size_t allocations = 0;
+
+} // namespace
+
+// every heap allocation of the process goes through here
+void *operator new(std::size_t size) {
+    allocations++;
+    if (void *pointer = std::malloc(size ? size : 1)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment) {
+    allocations++;
+    std::size_t align = static_cast<std::size_t>(alignment);
+    if (void *pointer = std::aligned_alloc(align, (size + align - 1) / align * align)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *pointer, std::align_val_t) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void *pointer, std::size_t, std::align_val_t) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void *pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void *pointer, std::size_t) noexcept {
+    std::free(pointer);
+}
+
+namespace {
+
+std::size_t sink = 0;
+
+// the request arena of Endpoint::serve, or none
+void measure(char const *name, bool withArena, int iterations, std::function<std::size_t()> const &request) {
+    std::size_t allocationsBefore = 0;
+    auto started = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < iterations; i++) {
+        if (i == 1) {
+            // the first round warms up caches and the allocator
+            allocationsBefore = allocations;
+            started = std::chrono::steady_clock::now();
+        }
+
+        if (withArena) {
+            std::array<std::byte, 16 * 1024> arenaBuffer;
+            std::pmr::monotonic_buffer_resource arena(arenaBuffer.data(), arenaBuffer.size(), std::pmr::new_delete_resource());
+            RequestContext::Scope context(std::nullopt, RequestPriority::Interactive, &arena);
+
+            sink += request();
+        } else {
+            sink += request();
+        }
+    }
+
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - started;
+    double perRequest = static_cast<double>(allocations - allocationsBefore) / (iterations - 1);
+
+    std::printf("%-40s %10.1f ns/request %8.1f allocations/request\n", name, elapsed.count() / (iterations - 1), perRequest);
+}
+
+// what JsonParser did before it had its own allocator, as a baseline
+std::size_t serializeWithDefaultAllocator(std::vector<Item> const &items) {
+    rapidjson::Document itemArray(rapidjson::kArrayType);
+
+    for (auto const &item : items) {
+        rapidjson::Value jsonItem(rapidjson::kObjectType);
+        jsonItem.AddMember("id", item.getId(), itemArray.GetAllocator());
+        jsonItem.AddMember("title", rapidjson::Value(item.getTitle().data(), static_cast<rapidjson::SizeType>(item.getTitle().size()), itemArray.GetAllocator()), itemArray.GetAllocator());
+        jsonItem.AddMember("position", item.getPos(), itemArray.GetAllocator());
+        char timestamp[32];
+        std::size_t timestampLength = formatTimestamp(item.getTimestamp(), timestamp, sizeof(timestamp));
+        jsonItem.AddMember("timestamp", rapidjson::Value(timestamp, static_cast<rapidjson::SizeType>(timestampLength), itemArray.GetAllocator()), itemArray.GetAllocator());
+        itemArray.PushBack(jsonItem, itemArray.GetAllocator());
+    }
+
+    rapidjson::StringBuffer buffer;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+    itemArray.Accept(writer);
+
+    return std::string(buffer.GetString(), buffer.GetSize()).size();
+}
+
+} // namespace
+
+// Allocations and latency of the parser work of one request, on the heap and
+// in a request arena like the one Endpoint::serve installs.
+int main(int argc, char **argv) {
+    int iterations = (argc > 1) ? std::stoi(argv[1]) : 20000;
+
+    JsonParser parser;
+    std::vector<Item> items;
+    for (int i = 1; i <= 50; i++) {
+        items.emplace_back(i, "item " + std::to_string(i), i, 1704067200);
+    }
+    Column column(1, "column", 1);
+    for (auto &item : items)
+        column.addItem(item);
+    std::string itemRequest = "{\"title\":\"benchmark\",\"position\":1}";
+
+    for (bool withArena : {false, true}) {
+        std::string form = withArena ? "arena" : "heap";
+        std::string label;
+
+        label = form + " items (default allocator)";
+        measure(label.c_str(), withArena, iterations, [&items]() {
+            return serializeWithDefaultAllocator(items);
+        });
+
+        label = form + " items";
+        measure(label.c_str(), withArena, iterations, [&parser, &items]() {
+            return parser.convertToApiString(items).size();
+        });
+
+        label = form + " column";
+        measure(label.c_str(), withArena, iterations, [&parser, &column]() {
+            return parser.convertToApiString(column).size();
+        });
+
+        label = form + " parse item";
+        measure(label.c_str(), withArena, iterations, [&parser, &itemRequest]() {
+            return parser.convertItemToModel(1, itemRequest)->getTitle().size();
+        });
+    }
+
+    return sink == 0;
+}
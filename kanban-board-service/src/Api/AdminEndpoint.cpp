@@ -0,0 +1,167 @@
+#include "AdminEndpoint.hpp"
+#include "rapidjson/stringbuffer.h"
+#include "rapidjson/writer.h"
+
+using namespace Prog3::Api;
+using namespace Prog3::Core::Metrics;
+using namespace Prog3::Repository::SQLite;
+using namespace crow;
+using namespace std;
+
+AdminEndpoint::AdminEndpoint(SimpleApp &givenApp, MetricsRegistry &givenMetrics, BackupService &givenBackupService,
+                             QueryProfiler &givenQueryProfiler, BoardRepositoryPool &givenRepositoryPool)
+    : app(givenApp), metrics(givenMetrics), backupService(givenBackupService), queryProfiler(givenQueryProfiler),
+      repositoryPool(givenRepositoryPool) {
+    registerRoutes();
+}
+
+AdminEndpoint::~AdminEndpoint() {
+}
+
+void AdminEndpoint::registerRoutes() {
+    CROW_ROUTE(app, "/api/admin/metrics")
+    ([this](const request &, response &res) {
+        res.set_header("Content-Type", "text/plain; version=0.0.4");
+        res.write(metrics.toText());
+        res.end();
+    });
+
+    CROW_ROUTE(app, "/api/admin/backup")
+        .methods("POST"_method)([this](const request &, response &res) {
+            // the backup runs in the background, progress shows up in the metrics.
+            // a trigger during a running backup joins that one instead of queueing
+            res.code = 202;
+            if (backupService.start()) {
+                res.write("{\"status\":\"started\"}");
+            } else {
+                res.write("{\"status\":\"running\"}");
+            }
+            res.end();
+        });
+
+    CROW_ROUTE(app, "/api/admin/queries")
+    ([this](const request &req, response &res) {
+        int limit = DEFAULT_QUERY_LIMIT;
+        if (char const *limitParameter = req.url_params.get("limit")) {
+            limit = std::max(1, std::atoi(limitParameter));
+        }
+
+        rapidjson::StringBuffer buffer;
+        rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+
+        writer.StartArray();
+        for (auto const &statistics : queryProfiler.getSlowestStatements(limit)) {
+            writer.StartObject();
+            writer.Key("statement");
+            writer.String(statistics.statement.c_str());
+            writer.Key("count");
+            writer.Int64(statistics.count);
+            writer.Key("totalMs");
+            writer.Double(statistics.totalNanoseconds / 1e6);
+            writer.Key("meanMs");
+            writer.Double(statistics.totalNanoseconds / 1e6 / statistics.count);
+            writer.Key("maxMs");
+            writer.Double(statistics.maxNanoseconds / 1e6);
+            writer.Key("plan");
+            writer.String(statistics.plan.c_str());
+            writer.EndObject();
+        }
+        writer.EndArray();
+
+        res.write(buffer.GetString());
+        res.end();
+    });
+
+    CROW_ROUTE(app, "/api/admin/storage")
+    ([this](const request &, response &res) {
+        res.write(getStorageReport());
+        res.end();
+    });
+}
+
+std::string AdminEndpoint::getStorageReport() {
+    rapidjson::StringBuffer buffer;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+
+    // process wide allocator numbers, all boards share them
+    struct GlobalStatus {
+        char const *name;
+        int operation;
+    };
+    GlobalStatus const globalStatus[] = {
+        {"memoryUsed", SQLITE_STATUS_MEMORY_USED},
+        {"mallocCount", SQLITE_STATUS_MALLOC_COUNT},
+        {"largestMalloc", SQLITE_STATUS_MALLOC_SIZE},
+        {"pageCacheUsed", SQLITE_STATUS_PAGECACHE_USED},
+        {"pageCacheOverflow", SQLITE_STATUS_PAGECACHE_OVERFLOW},
+        {"largestPageCacheAllocation", SQLITE_STATUS_PAGECACHE_SIZE},
+    };
+
+    writer.StartObject();
+    writer.Key("memory");
+    writer.StartObject();
+    for (auto const &status : globalStatus) {
+        sqlite3_int64 current = 0;
+        sqlite3_int64 highwater = 0;
+        sqlite3_status64(status.operation, &current, &highwater, 0);
+
+        writer.Key(status.name);
+        writer.StartObject();
+        writer.Key("current");
+        writer.Int64(current);
+        writer.Key("highwater");
+        writer.Int64(highwater);
+        writer.EndObject();
+    }
+    writer.EndObject();
+
+    writer.Key("boards");
+    writer.StartArray();
+    repositoryPool.forEachRepository([&writer](int boardId, BoardRepository &repository) {
+        StorageStatistics statistics = repository.getStorageStatistics();
+
+        writer.StartObject();
+        writer.Key("id");
+        writer.Int(boardId);
+        writer.Key("databaseBytes");
+        writer.Int64(statistics.databaseBytes);
+        writer.Key("walBytes");
+        writer.Int64(statistics.walBytes);
+        writer.Key("pageSize");
+        writer.Int64(statistics.pageSize);
+        writer.Key("pageCount");
+        writer.Int64(statistics.pageCount);
+        writer.Key("freelistCount");
+        writer.Int64(statistics.freelistCount);
+        writer.Key("cacheSize");
+        writer.Int64(statistics.cacheSize);
+        writer.Key("mmapSize");
+        writer.Int64(statistics.mmapSize);
+        writer.Key("cache");
+        writer.StartObject();
+        writer.Key("usedBytes");
+        writer.Int64(statistics.cacheUsedBytes);
+        writer.Key("hits");
+        writer.Int64(statistics.cacheHits);
+        writer.Key("misses");
+        writer.Int64(statistics.cacheMisses);
+        writer.Key("writes");
+        writer.Int64(statistics.cacheWrites);
+        writer.Key("spills");
+        writer.Int64(statistics.cacheSpills);
+        writer.EndObject();
+        writer.Key("schemaBytes");
+        writer.Int64(statistics.schemaBytes);
+        writer.Key("statementBytes");
+        writer.Int64(statistics.statementBytes);
+        writer.Key("lookasideUsed");
+        writer.Int64(statistics.lookasideUsed);
+        writer.Key("lookasideHighwater");
+        writer.Int64(statistics.lookasideHighwater);
+        writer.EndObject();
+    });
+    writer.EndArray();
+    writer.EndObject();
+
+    return buffer.GetString();
+}
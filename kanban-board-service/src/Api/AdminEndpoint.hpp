@@ -0,0 +1,35 @@
+#pragma once
+
+#include "Core/Metrics/MetricsRegistry.hpp"
+#include "Repository/SQLite/BackupService.hpp"
+#include "Repository/SQLite/QueryProfiler.hpp"
+#include "crow.h"
+
+namespace Prog3 {
+namespace Api {
+
+// Operational routes under /api/admin, kept apart from the board api.
+class AdminEndpoint {
+  public:
+    AdminEndpoint(crow::SimpleApp &givenApp, Prog3::Core::Metrics::MetricsRegistry &givenMetrics,
+                  Prog3::Repository::SQLite::BackupService &givenBackupService,
+                  Prog3::Repository::SQLite::QueryProfiler &givenQueryProfiler,
+                  Prog3::Repository::SQLite::BoardRepositoryPool &givenRepositoryPool);
+    ~AdminEndpoint();
+
+    void registerRoutes();
+
+  private:
+    crow::SimpleApp &app;
+    Prog3::Core::Metrics::MetricsRegistry &metrics;
+    Prog3::Repository::SQLite::BackupService &backupService;
+    Prog3::Repository::SQLite::QueryProfiler &queryProfiler;
+    Prog3::Repository::SQLite::BoardRepositoryPool &repositoryPool;
+
+    std::string getStorageReport();
+
+    static inline int const DEFAULT_QUERY_LIMIT = 10;
+};
+
+} // namespace Api
+} // namespace Prog3
@@ -1,14 +1,25 @@
 #include "Endpoint.hpp"
+#include "Core/Exception/DeadlineExceededException.hpp"
+#include "Core/Exception/TooManyBoardsException.hpp"
+#include "Repository/SQLite/BoardRepositoryPool.hpp"
+#include <algorithm>
+#include <array>
+#include <cstddef>
 #include <iostream>
+#include <limits>
 #include <string>
 
 using namespace Prog3::Api;
 using namespace Prog3::Core;
+using namespace Prog3::Core::Admission;
+using namespace Prog3::Core::Exception;
 using namespace crow;
 using namespace std;
 
-Endpoint::Endpoint(SimpleApp &givenApp, BoardManager &givenBoardManager) : app(givenApp),
-                                                                           boardManager(givenBoardManager) {
+Endpoint::Endpoint(SimpleApp &givenApp, BoardDirectory &givenBoardDirectory, AdmissionController &givenAdmissionController,
+                   DeadlineOptions givenDeadlineOptions)
+    : app(givenApp), boardDirectory(givenBoardDirectory), admissionController(givenAdmissionController),
+      deadlineOptions(givenDeadlineOptions) {
     registerRoutes();
 }
 
@@ -16,108 +27,337 @@ Endpoint::~Endpoint() {
 }
 
 void Endpoint::registerRoutes() {
+    int const defaultBoardId = Prog3::Repository::SQLite::BoardRepositoryPool::DEFAULT_BOARD_ID;
+
     CROW_ROUTE(app, "/api/board")
-    ([this](const request &req, response &res) {
-        std::string jsonBoards = boardManager.getBoard();
-        res.write(jsonBoards);
-        res.end();
+    ([this, defaultBoardId](const request &req, response &res) {
+        serveBoard(req, res, defaultBoardId, [&](BoardManager &boardManager) { handleBoard(boardManager, req, res); });
     });
 
-    CROW_ROUTE(app, "/api/board/columns")
-        .methods("GET"_method, "POST"_method)([this](const request &req, response &res) {
-            std::string jsonColumns;
+    CROW_ROUTE(app, "/api/board/changes")
+    ([this, defaultBoardId](const request &req, response &res) {
+        serveBoard(req, res, defaultBoardId, [&](BoardManager &boardManager) { handleChanges(boardManager, req, res); });
+    });
 
-            switch (req.method) {
-            case HTTPMethod::Get: {
-                jsonColumns = boardManager.getColumns();
-                break;
-            }
-            case HTTPMethod::Post: {
-                jsonColumns = boardManager.postColumn(req.body);
-                res.code = 201;
-                break;
-            }
-            default: {
-                break;
-            }
-            }
+    CROW_ROUTE(app, "/api/board/search")
+    ([this, defaultBoardId](const request &req, response &res) {
+        serveBoard(req, res, defaultBoardId, [&](BoardManager &boardManager) { handleSearch(boardManager, req, res); });
+    });
 
-            res.write(jsonColumns);
-            res.end();
+    CROW_ROUTE(app, "/api/board/archive")
+    ([this, defaultBoardId](const request &req, response &res) {
+        serveBoard(req, res, defaultBoardId, [&](BoardManager &boardManager) { handleArchive(boardManager, req, res); });
+    });
+
+    CROW_ROUTE(app, "/api/board/columns")
+        .methods("GET"_method, "POST"_method)([this, defaultBoardId](const request &req, response &res) {
+            serveBoard(req, res, defaultBoardId, [&](BoardManager &boardManager) { handleColumns(boardManager, req, res); });
         });
 
     CROW_ROUTE(app, "/api/board/columns/<int>")
-        .methods("GET"_method, "PUT"_method, "DELETE"_method)([this](const request &req, response &res, int columnID) {
-            std::string jsonColumn = "{}";
+        .methods("GET"_method, "PUT"_method, "DELETE"_method)([this, defaultBoardId](const request &req, response &res, std::int64_t columnID) {
+            serveBoard(req, res, defaultBoardId, [&](BoardManager &boardManager) { handleColumn(boardManager, req, res, columnID); });
+        });
 
-            switch (req.method) {
-            case HTTPMethod::Get: {
-                jsonColumn = boardManager.getColumn(columnID);
-                break;
-            }
-            case HTTPMethod::Put: {
-                jsonColumn = boardManager.putColumn(columnID, req.body);
-                break;
-            }
-            case HTTPMethod::Delete: {
-                boardManager.deleteColumn(columnID);
-                break;
-            }
-            default: {
-                break;
-            }
+    CROW_ROUTE(app, "/api/board/columns/<int>/items")
+        .methods("GET"_method, "POST"_method)([this, defaultBoardId](const request &req, response &res, std::int64_t columnID) {
+            serveBoard(req, res, defaultBoardId, [&](BoardManager &boardManager) { handleItems(boardManager, req, res, columnID); });
+        });
+
+    CROW_ROUTE(app, "/api/board/columns/<int>/items/<int>")
+        .methods("GET"_method, "PUT"_method, "DELETE"_method)([this, defaultBoardId](const request &req, response &res, std::int64_t columnID, std::int64_t itemID) {
+            serveBoard(req, res, defaultBoardId, [&](BoardManager &boardManager) { handleItem(boardManager, req, res, columnID, itemID); });
+        });
+
+    // PUT creates the board, every other route answers 404 for a board that does not exist
+    CROW_ROUTE(app, "/api/boards/<int>")
+        .methods("GET"_method, "PUT"_method)([this](const request &req, response &res, std::int64_t boardID) {
+            if (req.method == HTTPMethod::Put) {
+                if (isValidBoardId(boardID, res))
+                    serve(req, res, [&]() { handleCreateBoard(req, res, static_cast<int>(boardID)); });
+                return;
             }
+            serveBoard(req, res, boardID, [&](BoardManager &boardManager) { handleBoard(boardManager, req, res); });
+        });
 
-            res.write(jsonColumn);
-            res.end();
+    CROW_ROUTE(app, "/api/boards/<int>/changes")
+    ([this](const request &req, response &res, std::int64_t boardID) {
+        serveBoard(req, res, boardID, [&](BoardManager &boardManager) { handleChanges(boardManager, req, res); });
+    });
+
+    CROW_ROUTE(app, "/api/boards/<int>/search")
+    ([this](const request &req, response &res, std::int64_t boardID) {
+        serveBoard(req, res, boardID, [&](BoardManager &boardManager) { handleSearch(boardManager, req, res); });
+    });
+
+    CROW_ROUTE(app, "/api/boards/<int>/archive")
+    ([this](const request &req, response &res, std::int64_t boardID) {
+        serveBoard(req, res, boardID, [&](BoardManager &boardManager) { handleArchive(boardManager, req, res); });
+    });
+
+    CROW_ROUTE(app, "/api/boards/<int>/columns")
+        .methods("GET"_method, "POST"_method)([this](const request &req, response &res, std::int64_t boardID) {
+            serveBoard(req, res, boardID, [&](BoardManager &boardManager) { handleColumns(boardManager, req, res); });
         });
 
-    CROW_ROUTE(app, "/api/board/columns/<int>/items")
-        .methods("GET"_method, "POST"_method)([this](const request &req, response &res, int columnID) {
-            std::string jsonItem;
+    CROW_ROUTE(app, "/api/boards/<int>/columns/<int>")
+        .methods("GET"_method, "PUT"_method, "DELETE"_method)([this](const request &req, response &res, std::int64_t boardID, std::int64_t columnID) {
+            serveBoard(req, res, boardID, [&](BoardManager &boardManager) { handleColumn(boardManager, req, res, columnID); });
+        });
 
-            switch (req.method) {
-            case HTTPMethod::Get: {
-                jsonItem = boardManager.getItems(columnID);
-                break;
-            }
-            case HTTPMethod::Post: {
-                jsonItem = boardManager.postItem(columnID, req.body);
-                res.code = 201;
-                break;
-            }
-            default: {
-                break;
-            }
-            }
+    CROW_ROUTE(app, "/api/boards/<int>/columns/<int>/items")
+        .methods("GET"_method, "POST"_method)([this](const request &req, response &res, std::int64_t boardID, std::int64_t columnID) {
+            serveBoard(req, res, boardID, [&](BoardManager &boardManager) { handleItems(boardManager, req, res, columnID); });
+        });
 
-            res.write(jsonItem);
-            res.end();
+    CROW_ROUTE(app, "/api/boards/<int>/columns/<int>/items/<int>")
+        .methods("GET"_method, "PUT"_method, "DELETE"_method)([this](const request &req, response &res, std::int64_t boardID, std::int64_t columnID, std::int64_t itemID) {
+            serveBoard(req, res, boardID, [&](BoardManager &boardManager) { handleItem(boardManager, req, res, columnID, itemID); });
         });
+}
 
-    CROW_ROUTE(app, "/api/board/columns/<int>/items/<int>")
-        .methods("GET"_method, "PUT"_method, "DELETE"_method)([this](const request &req, response &res, int columnID, int itemID) {
-            std::string jsonItem;
+void Endpoint::serve(const request &req, response &res, std::function<void()> const &handler) {
+    AdmissionController::Permit permit = admit(req, res);
+    if (!permit)
+        return;
 
-            switch (req.method) {
-            case HTTPMethod::Get: {
-                jsonItem = boardManager.getItem(columnID, itemID);
-                break;
-            }
-            case HTTPMethod::Put: {
-                jsonItem = boardManager.putItem(columnID, itemID, req.body);
-                break;
-            }
-            case HTTPMethod::Delete: {
-                boardManager.deleteItem(columnID, itemID);
-                break;
-            }
-            default: {
-                break;
-            }
-            }
+    // scratch memory of the request, mostly for the parser. the first
+    // REQUEST_ARENA_BYTES live on the stack, all of it goes away at once below
+    std::array<std::byte, REQUEST_ARENA_BYTES> arenaBuffer;
+    std::pmr::monotonic_buffer_resource arena(arenaBuffer.data(), arenaBuffer.size(), std::pmr::new_delete_resource());
+
+    RequestContext::Scope context(getDeadline(req), getPriority(req), &arena);
+
+    try {
+        RequestContext::checkDeadline();
+        handler();
+    } catch (DeadlineExceededException const &) {
+        // the client has most likely given up, the answer is for proxies and logs
+        CROW_LOG_INFO << "Deadline exceeded: " << req.raw_url;
+        res.code = 503;
+        res.end();
+    } catch (TooManyBoardsException const &) {
+        res.code = 503;
+        res.set_header("Retry-After", std::to_string(AdmissionController::RETRY_AFTER_SECONDS));
+        res.end();
+    }
+}
+
+void Endpoint::serveBoard(const request &req, response &res, std::int64_t boardId, std::function<void(BoardManager &)> const &handler) {
+    if (!isValidBoardId(boardId, res))
+        return;
 
-            res.write(jsonItem);
+    serve(req, res, [&]() {
+        BoardManager *boardManager = boardDirectory.getBoardManager(static_cast<int>(boardId));
+        if (!boardManager) {
+            res.code = 404;
             res.end();
-        });
+            return;
+        }
+
+        handler(*boardManager);
+    });
+}
+
+RequestContext::Clock::time_point Endpoint::getDeadline(const request &req) {
+    std::chrono::milliseconds timeout = (req.method == HTTPMethod::Get) ? deadlineOptions.readTimeout : deadlineOptions.writeTimeout;
+    std::string requestedTimeout = req.get_header_value("X-Request-Timeout-Ms");
+
+    if (!requestedTimeout.empty()) {
+        try {
+            timeout = std::chrono::milliseconds(std::clamp(std::stoll(requestedTimeout), 0LL, static_cast<long long>(deadlineOptions.maxTimeout.count())));
+        } catch (std::exception const &) {
+        }
+    }
+
+    return RequestContext::Clock::now() + timeout;
+}
+
+RequestPriority Endpoint::getPriority(const request &req) {
+    // clients can only lower their priority, e.g. import jobs
+    if (req.get_header_value("X-Request-Priority") == "bulk") {
+        return RequestPriority::Bulk;
+    }
+
+    return (req.method == HTTPMethod::Get) ? RequestPriority::Interactive : RequestPriority::Write;
+}
+
+AdmissionController::Permit Endpoint::admit(const request &req, response &res) {
+    RequestClass requestClass = (req.method == HTTPMethod::Get) ? RequestClass::Read : RequestClass::Write;
+    AdmissionController::Permit permit = admissionController.tryAcquire(requestClass);
+
+    if (!permit) {
+        res.code = 503;
+        res.set_header("Retry-After", std::to_string(AdmissionController::RETRY_AFTER_SECONDS));
+        res.end();
+    }
+
+    return permit;
+}
+
+bool Endpoint::isValidBoardId(std::int64_t boardId, response &res) {
+    if (boardId >= 0 && boardId <= std::numeric_limits<int>::max()) {
+        return true;
+    }
+
+    res.code = 404;
+    res.end();
+    return false;
+}
+
+int Endpoint::getIntParameter(const request &req, std::string const &name, int fallback) {
+    char const *value = req.url_params.get(name);
+
+    if (value) {
+        try {
+            return std::stoi(value);
+        } catch (std::exception const &) {
+        }
+    }
+
+    return fallback;
+}
+
+void Endpoint::handleCreateBoard(const request &, response &res, int boardId) {
+    bool existed = boardDirectory.getBoardManager(boardId) != nullptr;
+
+    std::string jsonBoard = boardDirectory.createBoardManager(boardId).getBoard();
+    res.code = existed ? 200 : 201;
+    res.write(jsonBoard);
+    res.end();
+}
+
+void Endpoint::handleBoard(BoardManager &boardManager, const request &, response &res) {
+    std::string jsonBoards = boardManager.getBoard();
+    res.write(jsonBoards);
+    res.end();
+}
+
+void Endpoint::handleSearch(BoardManager &boardManager, const request &req, response &res) {
+    char const *query = req.url_params.get("q");
+
+    std::string jsonHits = boardManager.searchItems(query ? query : "",
+                                                    getIntParameter(req, "limit", 0),
+                                                    getIntParameter(req, "offset", 0));
+    res.write(jsonHits);
+    res.end();
+}
+
+void Endpoint::handleArchive(BoardManager &boardManager, const request &req, response &res) {
+    std::string jsonArchivedItems = boardManager.getArchivedItems(getIntParameter(req, "limit", 0),
+                                                                  getIntParameter(req, "offset", 0));
+    res.write(jsonArchivedItems);
+    res.end();
+}
+
+void Endpoint::handleChanges(BoardManager &boardManager, const request &req, response &res) {
+    // without a usable version the client gets a full snapshot
+    std::int64_t sinceVersion = -1;
+    char const *since = req.url_params.get("since");
+
+    if (since) {
+        try {
+            sinceVersion = std::stoll(since);
+        } catch (std::exception const &) {
+            sinceVersion = -1;
+        }
+    }
+
+    std::string jsonChanges = boardManager.getChanges(sinceVersion);
+    res.write(jsonChanges);
+    res.end();
+}
+
+void Endpoint::handleColumns(BoardManager &boardManager, const request &req, response &res) {
+    std::string jsonColumns;
+
+    switch (req.method) {
+    case HTTPMethod::Get: {
+        jsonColumns = boardManager.getColumns();
+        break;
+    }
+    case HTTPMethod::Post: {
+        jsonColumns = boardManager.postColumn(req.body);
+        res.code = 201;
+        break;
+    }
+    default: {
+        break;
+    }
+    }
+
+    res.write(jsonColumns);
+    res.end();
+}
+
+void Endpoint::handleColumn(BoardManager &boardManager, const request &req, response &res, std::int64_t columnID) {
+    std::string jsonColumn = "{}";
+
+    switch (req.method) {
+    case HTTPMethod::Get: {
+        jsonColumn = boardManager.getColumn(columnID);
+        break;
+    }
+    case HTTPMethod::Put: {
+        jsonColumn = boardManager.putColumn(columnID, req.body);
+        break;
+    }
+    case HTTPMethod::Delete: {
+        boardManager.deleteColumn(columnID);
+        break;
+    }
+    default: {
+        break;
+    }
+    }
+
+    res.write(jsonColumn);
+    res.end();
+}
+
+void Endpoint::handleItems(BoardManager &boardManager, const request &req, response &res, std::int64_t columnID) {
+    std::string jsonItem;
+
+    switch (req.method) {
+    case HTTPMethod::Get: {
+        jsonItem = boardManager.getItems(columnID);
+        break;
+    }
+    case HTTPMethod::Post: {
+        jsonItem = boardManager.postItem(columnID, req.body);
+        res.code = 201;
+        break;
+    }
+    default: {
+        break;
+    }
+    }
+
+    res.write(jsonItem);
+    res.end();
+}
+
+void Endpoint::handleItem(BoardManager &boardManager, const request &req, response &res, std::int64_t columnID, std::int64_t itemID) {
+    std::string jsonItem;
+
+    switch (req.method) {
+    case HTTPMethod::Get: {
+        jsonItem = boardManager.getItem(columnID, itemID);
+        break;
+    }
+    case HTTPMethod::Put: {
+        jsonItem = boardManager.putItem(columnID, itemID, req.body);
+        break;
+    }
+    case HTTPMethod::Delete: {
+        boardManager.deleteItem(columnID, itemID);
+        break;
+    }
+    default: {
+        break;
+    }
+    }
+
+    res.write(jsonItem);
+    res.end();
 }
@@ -1,21 +1,57 @@
 #pragma once
 
-#include "Core/BoardManager.hpp"
+#include "Core/Admission/AdmissionController.hpp"
+#include "Core/BoardDirectory.hpp"
+#include "Core/RequestContext.hpp"
 #include "crow.h"
+#include <cstdint>
+#include <functional>
 
 namespace Prog3 {
 namespace Api {
 
 class Endpoint {
   public:
-    Endpoint(crow::SimpleApp &givenApp, Prog3::Core::BoardManager &givenBoardManager);
+    Endpoint(crow::SimpleApp &givenApp, Prog3::Core::BoardDirectory &givenBoardDirectory,
+             Prog3::Core::Admission::AdmissionController &givenAdmissionController,
+             Prog3::Core::DeadlineOptions givenDeadlineOptions);
     ~Endpoint();
 
     void registerRoutes();
 
   private:
     crow::SimpleApp &app;
-    Prog3::Core::BoardManager &boardManager;
+    Prog3::Core::BoardDirectory &boardDirectory;
+    Prog3::Core::Admission::AdmissionController &admissionController;
+    Prog3::Core::DeadlineOptions deadlineOptions;
+
+    static inline size_t const REQUEST_ARENA_BYTES = 16 * 1024;
+
+    // runs a board handler under admission control and the request's deadline,
+    // both end in a 503: right away when shed, once the deadline has passed otherwise
+    void serve(crow::request const &req, crow::response &res, std::function<void()> const &handler);
+    // serve for a handler of an existing board, 404 for any other board id
+    void serveBoard(crow::request const &req, crow::response &res, std::int64_t boardId,
+                    std::function<void(Prog3::Core::BoardManager &)> const &handler);
+    Prog3::Core::Admission::AdmissionController::Permit admit(crow::request const &req, crow::response &res);
+    Prog3::Core::RequestContext::Clock::time_point getDeadline(crow::request const &req);
+    static Prog3::Core::RequestPriority getPriority(crow::request const &req);
+
+    bool isValidBoardId(std::int64_t boardId, crow::response &res);
+    static int getIntParameter(crow::request const &req, std::string const &name, int fallback);
+
+    // PUT /api/boards/<id>, the only route that creates a board's file
+    void handleCreateBoard(crow::request const &req, crow::response &res, int boardId);
+
+    // shared by the default board under /api/board and every board under /api/boards/<id>
+    void handleBoard(Prog3::Core::BoardManager &boardManager, crow::request const &req, crow::response &res);
+    void handleSearch(Prog3::Core::BoardManager &boardManager, crow::request const &req, crow::response &res);
+    void handleArchive(Prog3::Core::BoardManager &boardManager, crow::request const &req, crow::response &res);
+    void handleChanges(Prog3::Core::BoardManager &boardManager, crow::request const &req, crow::response &res);
+    void handleColumns(Prog3::Core::BoardManager &boardManager, crow::request const &req, crow::response &res);
+    void handleColumn(Prog3::Core::BoardManager &boardManager, crow::request const &req, crow::response &res, std::int64_t columnID);
+    void handleItems(Prog3::Core::BoardManager &boardManager, crow::request const &req, crow::response &res, std::int64_t columnID);
+    void handleItem(Prog3::Core::BoardManager &boardManager, crow::request const &req, crow::response &res, std::int64_t columnID, std::int64_t itemID);
 };
 
 } // namespace Api
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "Core/RequestContext.hpp"
+#include "rapidjson/allocators.h"
+#include "rapidjson/document.h"
+#include "rapidjson/stringbuffer.h"
+#include <memory_resource>
+
+namespace Prog3 {
+namespace Api {
+namespace Parser {
+
+// Hands rapidjson's memory pool its chunks from a std::pmr resource. The
+// resource is monotonic, so chunks are never given back one by one.
+class JsonChunkAllocator {
+  private:
+    std::pmr::memory_resource *resource;
+
+  public:
+    static bool const kNeedFree = false;
+
+    // rapidjson's templates need it. JsonParser always passes the allocator of
+    // a JsonArena, one made up by rapidjson itself fails on its first use
+    JsonChunkAllocator() : resource(std::pmr::null_memory_resource()) {}
+    JsonChunkAllocator(std::pmr::memory_resource *givenResource) : resource(givenResource) {}
+
+    void *Malloc(size_t size) {
+        return size ? resource->allocate(size) : nullptr;
+    }
+
+    void *Realloc(void *originalPointer, size_t originalSize, size_t newSize);
+
+    static void Free(void *) {}
+};
+
+using JsonAllocator = rapidjson::MemoryPoolAllocator<JsonChunkAllocator>;
+using JsonValue = rapidjson::GenericValue<rapidjson::UTF8<>, JsonAllocator>;
+using JsonDocument = rapidjson::GenericDocument<rapidjson::UTF8<>, JsonAllocator, JsonAllocator>;
+using JsonStringBuffer = rapidjson::GenericStringBuffer<rapidjson::UTF8<>, JsonAllocator>;
+
+// Scratch memory of one parser call. Inside a request it is carved out of the
+// request's arena and only given back with it, outside of one (background
+// jobs, benchmarks) it comes from the heap and is released with the JsonArena.
+class JsonArena {
+  private:
+    std::pmr::monotonic_buffer_resource resource;
+    JsonChunkAllocator chunkAllocator;
+    JsonAllocator allocator;
+
+  public:
+    JsonArena()
+        : resource(Prog3::Core::RequestContext::current().getMemoryResource()), chunkAllocator(&resource),
+          allocator(CHUNK_BYTES, &chunkAllocator) {}
+
+    JsonArena(JsonArena const &) = delete;
+    JsonArena &operator=(JsonArena const &) = delete;
+
+    JsonAllocator *get() {
+        return &allocator;
+    }
+
+    static inline size_t const CHUNK_BYTES = 8 * 1024;
+    // initial stack of JsonDocument::Parse, rapidjson's default
+    static inline size_t const PARSE_STACK_BYTES = 1024;
+};
+
+inline void *JsonChunkAllocator::Realloc(void *originalPointer, size_t originalSize, size_t newSize) {
+    // only called for chunks, which never grow
+    (void)originalPointer;
+    (void)originalSize;
+
+    return Malloc(newSize);
+}
+
+} // namespace Parser
+} // namespace Api
+} // namespace Prog3
@@ -2,6 +2,7 @@
 
 #include "JsonParser.hpp"
 #include "Core/Exception/NotImplementedException.hpp"
+#include "Core/Model/Timestamp.hpp"
 #include "crow/logging.h"
 #include "rapidjson/prettywriter.h"
 #include "rapidjson/stringbuffer.h"
@@ -13,7 +14,7 @@ using namespace Prog3::Core::Exception;
 using namespace rapidjson;
 using namespace std;
 
-bool JsonParser::isValidColumn(rapidjson::Document const &document) {
+bool JsonParser::isValidColumn(JsonDocument const &document) {
     if (document.HasParseError() || !document["name"].IsString() || !document["position"].IsInt()) {
         return false;
     }
@@ -21,7 +22,7 @@ bool JsonParser::isValidColumn(rapidjson::Document const &document) {
     return true;
 }
 
-bool JsonParser::isValidItem(rapidjson::Document const &document) {
+bool JsonParser::isValidItem(JsonDocument const &document) {
     if (document.HasParseError() || !document["title"].IsString() || !document["position"].IsInt()) {
         return false;
     }
@@ -29,17 +30,17 @@ bool JsonParser::isValidItem(rapidjson::Document const &document) {
     return true;
 }
 
-rapidjson::Value JsonParser::getJsonValueFromModel(Column const &column, rapidjson::Document::AllocatorType &allocator) {
-    Value jsonColumn(kObjectType);
+JsonValue JsonParser::getJsonValueFromModel(Column const &column, JsonAllocator &allocator) {
+    JsonValue jsonColumn(kObjectType);
 
     jsonColumn.AddMember("id", column.getId(), allocator);
-    jsonColumn.AddMember("name", Value(column.getName().c_str(), allocator), allocator);
+    jsonColumn.AddMember("name", JsonValue(column.getName().c_str(), allocator), allocator);
     jsonColumn.AddMember("position", column.getPos(), allocator);
 
-    Value jsonItems(kArrayType);
+    JsonValue jsonItems(kArrayType);
 
     for (auto &item : column.getItems()) {
-        Value jsonItem = getJsonValueFromModel(item, allocator);
+        JsonValue jsonItem = getJsonValueFromModel(item, allocator);
         jsonItems.PushBack(jsonItem, allocator);
     }
 
@@ -48,77 +49,236 @@ rapidjson::Value JsonParser::getJsonValueFromModel(Column const &column, rapidjs
     return jsonColumn;
 }
 
-rapidjson::Value JsonParser::getJsonValueFromModel(Item const &item, rapidjson::Document::AllocatorType &allocator) {
-    Value jsonItem(kObjectType);
+JsonValue JsonParser::getJsonString(std::string_view text, JsonAllocator &allocator) {
+    return JsonValue(text.data(), static_cast<SizeType>(text.size()), allocator);
+}
+
+JsonValue JsonParser::getJsonTimestamp(Item const &item, JsonAllocator &allocator) {
+    if (!item.getDateText().empty())
+        return getJsonString(item.getDateText(), allocator);
+
+    char text[32];
+    size_t length = formatTimestamp(item.getTimestamp(), text, sizeof(text));
+
+    return JsonValue(text, static_cast<SizeType>(length), allocator);
+}
+
+JsonValue JsonParser::getJsonValueFromModel(Item const &item, JsonAllocator &allocator) {
+    JsonValue jsonItem(kObjectType);
 
     jsonItem.AddMember("id", item.getId(), allocator);
-    jsonItem.AddMember("title", Value(item.getTitle().c_str(), allocator), allocator);
+    jsonItem.AddMember("title", getJsonString(item.getTitle(), allocator), allocator);
     jsonItem.AddMember("position", item.getPos(), allocator);
-    jsonItem.AddMember("timestamp", Value(item.getTimestamp().c_str(), allocator), allocator);
+    jsonItem.AddMember("timestamp", getJsonTimestamp(item, allocator), allocator);
 
     return jsonItem;
 }
 
-string JsonParser::jsonValueToString(rapidjson::Value const &json) {
-    StringBuffer buffer;
-    Writer<StringBuffer> writer(buffer);
+JsonValue JsonParser::getJsonValueFromModel(Change const &change, JsonAllocator &allocator) {
+    JsonValue jsonChange(kObjectType);
 
-    json.Accept(writer);
+    char const *operation = "delete";
+    if (change.getOperation() == Change::Operation::Insert) {
+        operation = "insert";
+    } else if (change.getOperation() == Change::Operation::Update) {
+        operation = "update";
+    }
+
+    jsonChange.AddMember("seq", change.getSequence(), allocator);
+    jsonChange.AddMember("operation", JsonValue(operation, allocator), allocator);
+
+    if (change.getEntity() == Change::Entity::Column) {
+        jsonChange.AddMember("type", "column", allocator);
+        jsonChange.AddMember("id", change.getId(), allocator);
+
+        if (auto column = change.getColumn()) {
+            jsonChange.AddMember("name", JsonValue(column->getName().c_str(), allocator), allocator);
+            jsonChange.AddMember("position", column->getPos(), allocator);
+        }
+    } else {
+        jsonChange.AddMember("type", "item", allocator);
+        jsonChange.AddMember("id", change.getId(), allocator);
+        jsonChange.AddMember("columnId", change.getColumnId(), allocator);
+
+        if (auto item = change.getItem()) {
+            jsonChange.AddMember("title", getJsonString(item->getTitle(), allocator), allocator);
+            jsonChange.AddMember("position", item->getPos(), allocator);
+            jsonChange.AddMember("timestamp", getJsonTimestamp(*item, allocator), allocator);
+        }
+    }
 
-    return buffer.GetString();
+    return jsonChange;
 }
 
-string JsonParser::convertToApiString(Board &board) {
-    Document document(kObjectType);
+JsonValue JsonParser::getJsonValueFromModel(Board &board, JsonAllocator &allocator) {
+    JsonValue jsonBoard(kObjectType);
 
-    document.AddMember("title", Value(board.getTitle().c_str(), document.GetAllocator()), document.GetAllocator());
+    jsonBoard.AddMember("title", JsonValue(board.getTitle().c_str(), allocator), allocator);
 
-    Value columnArray(kArrayType);
+    JsonValue columnArray(kArrayType);
 
     for (auto &column : board.getColumns())
-        columnArray.PushBack(getJsonValueFromModel(column, document.GetAllocator()), document.GetAllocator());
+        columnArray.PushBack(getJsonValueFromModel(column, allocator), allocator);
 
-    document.AddMember("columns", columnArray, document.GetAllocator());
+    jsonBoard.AddMember("columns", columnArray, allocator);
 
-    return jsonValueToString(document);
+    return jsonBoard;
 }
 
-string JsonParser::convertToApiString(Column &column) {
-    Document document(kObjectType);
+string JsonParser::jsonValueToString(JsonValue const &json, JsonAllocator &allocator) {
+    JsonStringBuffer buffer(&allocator);
+    Writer<JsonStringBuffer, UTF8<>, UTF8<>, JsonAllocator> writer(buffer, &allocator);
 
-    Value jsonColumn = getJsonValueFromModel(column, document.GetAllocator());
+    json.Accept(writer);
 
-    return jsonValueToString(jsonColumn);
+    return string(buffer.GetString(), buffer.GetSize());
+}
+
+string JsonParser::convertToApiString(Board &board) {
+    JsonArena arena;
+    JsonDocument document(kObjectType, arena.get());
+
+    JsonValue jsonBoard = getJsonValueFromModel(board, document.GetAllocator());
+
+    return jsonValueToString(jsonBoard, *arena.get());
+}
+
+string JsonParser::convertToApiString(Column const &column) {
+    JsonArena arena;
+    JsonDocument document(kObjectType, arena.get());
+
+    JsonValue jsonColumn = getJsonValueFromModel(column, document.GetAllocator());
+
+    return jsonValueToString(jsonColumn, *arena.get());
 }
 
 string JsonParser::convertToApiString(std::vector<Column> &columns) {
-    Document columnArray(kArrayType);
+    JsonArena arena;
+    JsonDocument columnArray(kArrayType, arena.get());
 
     for (auto &column : columns)
         columnArray.PushBack(getJsonValueFromModel(column, columnArray.GetAllocator()), columnArray.GetAllocator());
 
-    return jsonValueToString(columnArray);
+    return jsonValueToString(columnArray, *arena.get());
 }
 
-string JsonParser::convertToApiString(Item &item) {
-    Document document(kObjectType);
+string JsonParser::convertToApiString(Item const &item) {
+    JsonArena arena;
+    JsonDocument document(kObjectType, arena.get());
 
-    Value jsonItem = getJsonValueFromModel(item, document.GetAllocator());
+    JsonValue jsonItem = getJsonValueFromModel(item, document.GetAllocator());
 
-    return jsonValueToString(jsonItem);
+    return jsonValueToString(jsonItem, *arena.get());
 }
 
-string JsonParser::convertToApiString(std::vector<Item> &items) {
-    Document itemArray(kArrayType);
+string JsonParser::convertToApiString(std::vector<Item> const &items) {
+    JsonArena arena;
+    JsonDocument itemArray(kArrayType, arena.get());
 
     for (auto &item : items)
         itemArray.PushBack(getJsonValueFromModel(item, itemArray.GetAllocator()), itemArray.GetAllocator());
 
-    return jsonValueToString(itemArray);
+    return jsonValueToString(itemArray, *arena.get());
+}
+
+string JsonParser::assembleBoardApiString(std::string const &title, ColumnFragments const &columnFragments) {
+    JsonArena arena;
+    JsonStringBuffer titleBuffer(arena.get());
+    Writer<JsonStringBuffer, UTF8<>, UTF8<>, JsonAllocator> writer(titleBuffer, arena.get());
+    writer.String(title.c_str(), static_cast<SizeType>(title.size()));
+
+    string columns = assembleColumnsApiString(columnFragments);
+    string json;
+    json.reserve(titleBuffer.GetSize() + columns.size() + 24);
+
+    json += "{\"title\":";
+    json.append(titleBuffer.GetString(), titleBuffer.GetSize());
+    json += ",\"columns\":";
+    json += columns;
+    json += "}";
+
+    return json;
+}
+
+string JsonParser::assembleColumnsApiString(ColumnFragments const &columnFragments) {
+    size_t length = 2;
+    for (auto const &fragment : columnFragments)
+        length += fragment->size() + 1;
+
+    string json;
+    json.reserve(length);
+
+    json += "[";
+    for (size_t i = 0; i < columnFragments.size(); i++) {
+        if (i > 0) {
+            json += ",";
+        }
+        json += *columnFragments[i];
+    }
+    json += "]";
+
+    return json;
+}
+
+string JsonParser::convertToApiString(ChangeSet &changes) {
+    JsonArena arena;
+    JsonDocument document(kObjectType, arena.get());
+
+    document.AddMember("version", changes.getVersion(), document.GetAllocator());
+    document.AddMember("snapshot", false, document.GetAllocator());
+
+    JsonValue changeArray(kArrayType);
+
+    for (auto &change : changes.getChanges())
+        changeArray.PushBack(getJsonValueFromModel(change, document.GetAllocator()), document.GetAllocator());
+
+    document.AddMember("changes", changeArray, document.GetAllocator());
+
+    return jsonValueToString(document, *arena.get());
+}
+
+string JsonParser::convertToApiString(Board &board, std::int64_t version) {
+    JsonArena arena;
+    JsonDocument document(kObjectType, arena.get());
+
+    document.AddMember("version", version, document.GetAllocator());
+    document.AddMember("snapshot", true, document.GetAllocator());
+    document.AddMember("board", getJsonValueFromModel(board, document.GetAllocator()), document.GetAllocator());
+
+    return jsonValueToString(document, *arena.get());
+}
+
+string JsonParser::convertToApiString(std::vector<SearchHit> &hits) {
+    JsonArena arena;
+    JsonDocument hitArray(kArrayType, arena.get());
+
+    for (auto &hit : hits) {
+        JsonValue jsonHit = getJsonValueFromModel(hit.getItem(), hitArray.GetAllocator());
+        jsonHit.AddMember("columnId", hit.getColumnId(), hitArray.GetAllocator());
+        hitArray.PushBack(jsonHit, hitArray.GetAllocator());
+    }
+
+    return jsonValueToString(hitArray, *arena.get());
+}
+
+string JsonParser::convertToApiString(std::vector<ArchivedItem> &archivedItems) {
+    JsonArena arena;
+    JsonDocument itemArray(kArrayType, arena.get());
+
+    for (auto &archivedItem : archivedItems) {
+        JsonValue jsonItem = getJsonValueFromModel(archivedItem.getItem(), itemArray.GetAllocator());
+        jsonItem.AddMember("columnId", archivedItem.getColumnId(), itemArray.GetAllocator());
+        jsonItem.AddMember("columnName", JsonValue(archivedItem.getColumnName().c_str(), itemArray.GetAllocator()), itemArray.GetAllocator());
+        jsonItem.AddMember("archivedAt", archivedItem.getArchivedAt(), itemArray.GetAllocator());
+        itemArray.PushBack(jsonItem, itemArray.GetAllocator());
+    }
+
+    return jsonValueToString(itemArray, *arena.get());
 }
 
-std::optional<Column> JsonParser::convertColumnToModel(int columnId, std::string &request) {
-    Document document;
+std::optional<Column> JsonParser::convertColumnToModel(std::int64_t columnId, std::string &request) {
+    JsonArena arena;
+    JsonDocument document(arena.get(), JsonArena::PARSE_STACK_BYTES, arena.get());
     document.Parse(request.c_str());
 
     if (isValidColumn(document)) {
@@ -128,13 +288,15 @@ std::optional<Column> JsonParser::convertColumnToModel(int columnId, std::string
     return {};
 }
 
-std::optional<Item> JsonParser::convertItemToModel(int itemId, std::string &request) {
-    Document document;
+std::optional<Item> JsonParser::convertItemToModel(std::int64_t itemId, std::string &request) {
+    JsonArena arena;
+    JsonDocument document(arena.get(), JsonArena::PARSE_STACK_BYTES, arena.get());
     document.Parse(request.c_str());
 
     if (isValidItem(document)) {
         // we don't care about the timestamp here
-        return Item(itemId, document["title"].GetString(), document["position"].GetInt(), "");
+        auto const &title = document["title"];
+        return Item(itemId, std::string_view(title.GetString(), title.GetStringLength()), document["position"].GetInt(), 0);
     }
 
     return {};
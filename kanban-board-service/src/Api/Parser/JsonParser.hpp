@@ -1,23 +1,30 @@
 #pragma once
 
+#include "JsonArena.hpp"
 #include "ParserIf.hpp"
-#include "rapidjson/document.h"
 
 namespace Prog3 {
 namespace Api {
 namespace Parser {
 
-class JsonParser : public ParserIf {
+class JsonParser final : public ParserIf {
   private:
     static inline std::string const EMPTY_JSON = "{}";
 
-    bool isValidColumn(rapidjson::Document const &document);
-    bool isValidItem(rapidjson::Document const &document);
+    bool isValidColumn(JsonDocument const &document);
+    bool isValidItem(JsonDocument const &document);
 
-    rapidjson::Value getJsonValueFromModel(Prog3::Core::Model::Item const &item, rapidjson::Document::AllocatorType &allocator);
-    rapidjson::Value getJsonValueFromModel(Prog3::Core::Model::Column const &column, rapidjson::Document::AllocatorType &allocator);
+    JsonValue getJsonString(std::string_view text, JsonAllocator &allocator);
+    // ctime() form, the same text as the date column. A date text that could not be
+    // parsed is written as it is
+    JsonValue getJsonTimestamp(Prog3::Core::Model::Item const &item, JsonAllocator &allocator);
+    JsonValue getJsonValueFromModel(Prog3::Core::Model::Item const &item, JsonAllocator &allocator);
+    JsonValue getJsonValueFromModel(Prog3::Core::Model::Column const &column, JsonAllocator &allocator);
+    JsonValue getJsonValueFromModel(Prog3::Core::Model::Change const &change, JsonAllocator &allocator);
+    JsonValue getJsonValueFromModel(Prog3::Core::Model::Board &board, JsonAllocator &allocator);
 
-    std::string jsonValueToString(rapidjson::Value const &json);
+    // the buffers of the writer come from allocator as well
+    std::string jsonValueToString(JsonValue const &json, JsonAllocator &allocator);
 
   public:
     JsonParser(){};
@@ -25,14 +32,22 @@ class JsonParser : public ParserIf {
 
     virtual std::string convertToApiString(Prog3::Core::Model::Board &board);
 
-    virtual std::string convertToApiString(Prog3::Core::Model::Column &column);
+    virtual std::string convertToApiString(Prog3::Core::Model::Column const &column);
     virtual std::string convertToApiString(std::vector<Prog3::Core::Model::Column> &columns);
 
-    virtual std::string convertToApiString(Prog3::Core::Model::Item &item);
-    virtual std::string convertToApiString(std::vector<Prog3::Core::Model::Item> &items);
+    virtual std::string convertToApiString(Prog3::Core::Model::Item const &item);
+    virtual std::string convertToApiString(std::vector<Prog3::Core::Model::Item> const &items);
 
-    virtual std::optional<Prog3::Core::Model::Column> convertColumnToModel(int columnId, std::string &request);
-    virtual std::optional<Prog3::Core::Model::Item> convertItemToModel(int itemId, std::string &request);
+    virtual std::string convertToApiString(Prog3::Core::Model::ChangeSet &changes);
+    virtual std::string convertToApiString(Prog3::Core::Model::Board &board, std::int64_t version);
+    virtual std::string convertToApiString(std::vector<Prog3::Core::Model::SearchHit> &hits);
+    virtual std::string convertToApiString(std::vector<Prog3::Core::Model::ArchivedItem> &archivedItems);
+
+    virtual std::string assembleBoardApiString(std::string const &title, ColumnFragments const &columnFragments);
+    virtual std::string assembleColumnsApiString(ColumnFragments const &columnFragments);
+
+    virtual std::optional<Prog3::Core::Model::Column> convertColumnToModel(std::int64_t columnId, std::string &request);
+    virtual std::optional<Prog3::Core::Model::Item> convertItemToModel(std::int64_t itemId, std::string &request);
 
     virtual std::string getEmptyResponseString() {
         return JsonParser::EMPTY_JSON;
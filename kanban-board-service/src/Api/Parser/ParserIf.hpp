@@ -1,7 +1,11 @@
 #pragma once
 
+#include "Core/Model/ArchivedItem.hpp"
 #include "Core/Model/Board.hpp"
+#include "Core/Model/ChangeSet.hpp"
+#include "Core/Model/SearchHit.hpp"
 #include "optional"
+#include <memory>
 
 namespace Prog3 {
 namespace Api {
@@ -9,19 +13,31 @@ namespace Parser {
 
 class ParserIf {
   public:
+    // columns serialized one by one with convertToApiString(Column const &)
+    using ColumnFragments = std::vector<std::shared_ptr<std::string const>>;
+
     virtual ~ParserIf() {}
 
     virtual std::string getEmptyResponseString() = 0;
 
     virtual std::string convertToApiString(Prog3::Core::Model::Board &board) = 0;
-    virtual std::string convertToApiString(Prog3::Core::Model::Column &column) = 0;
+    virtual std::string convertToApiString(Prog3::Core::Model::Column const &column) = 0;
     virtual std::string convertToApiString(std::vector<Prog3::Core::Model::Column> &columns) = 0;
 
-    virtual std::string convertToApiString(Prog3::Core::Model::Item &item) = 0;
-    virtual std::string convertToApiString(std::vector<Prog3::Core::Model::Item> &items) = 0;
+    virtual std::string convertToApiString(Prog3::Core::Model::Item const &item) = 0;
+    virtual std::string convertToApiString(std::vector<Prog3::Core::Model::Item> const &items) = 0;
+
+    virtual std::string convertToApiString(Prog3::Core::Model::ChangeSet &changes) = 0;
+    virtual std::string convertToApiString(Prog3::Core::Model::Board &board, std::int64_t version) = 0;
+    virtual std::string convertToApiString(std::vector<Prog3::Core::Model::SearchHit> &hits) = 0;
+    virtual std::string convertToApiString(std::vector<Prog3::Core::Model::ArchivedItem> &archivedItems) = 0;
+
+    // the same documents as convertToApiString(Board &) and convertToApiString(std::vector<Column> &)
+    virtual std::string assembleBoardApiString(std::string const &title, ColumnFragments const &columnFragments) = 0;
+    virtual std::string assembleColumnsApiString(ColumnFragments const &columnFragments) = 0;
 
-    virtual std::optional<Prog3::Core::Model::Column> convertColumnToModel(int columnId, std::string &request) = 0;
-    virtual std::optional<Prog3::Core::Model::Item> convertItemToModel(int itemId, std::string &request) = 0;
+    virtual std::optional<Prog3::Core::Model::Column> convertColumnToModel(std::int64_t columnId, std::string &request) = 0;
+    virtual std::optional<Prog3::Core::Model::Item> convertItemToModel(std::int64_t itemId, std::string &request) = 0;
 };
 
 } // namespace Parser
@@ -0,0 +1,42 @@
+#include "RequestDriver.hpp"
+
+using namespace Prog3::Api;
+using namespace crow;
+using namespace std;
+
+RequestDriver::RequestDriver(SimpleApp &givenApp) : app(givenApp) {
+    app.validate();
+}
+
+RequestDriver::~RequestDriver() {
+}
+
+response RequestDriver::send(HTTPMethod method, std::string const &target, std::string const &body, ci_map const &headers) {
+    request req(method, target, target.substr(0, target.find('?')), query_string(target), headers, body);
+
+    // handlers answer synchronously, 404s and exceptions are answered by the router
+    response res;
+    app.handle(req, res);
+
+    if (!res.is_completed()) {
+        CROW_LOG_ERROR << "Handler did not complete " << method_name(method) << " " << target;
+    }
+
+    return res;
+}
+
+response RequestDriver::get(std::string const &target, ci_map const &headers) {
+    return send(HTTPMethod::Get, target, "", headers);
+}
+
+response RequestDriver::post(std::string const &target, std::string const &body, ci_map const &headers) {
+    return send(HTTPMethod::Post, target, body, headers);
+}
+
+response RequestDriver::put(std::string const &target, std::string const &body, ci_map const &headers) {
+    return send(HTTPMethod::Put, target, body, headers);
+}
+
+response RequestDriver::remove(std::string const &target, ci_map const &headers) {
+    return send(HTTPMethod::Delete, target, "", headers);
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "crow.h"
+#include <string>
+
+namespace Prog3 {
+namespace Api {
+
+// Dispatches requests through the routes of an app without a socket, for
+// C++ tests and handler benchmarks. The request goes through the same router
+// and handlers as one read from a connection, the response is returned as the
+// handler left it: no Content-Length, no keep-alive handling.
+class RequestDriver {
+  public:
+    // the app's routes must be registered, the driver validates the router.
+    // Crow can validate a router only once, a second validate() throws
+    // "handler already exists": the app must not have been validated or run
+    // before, must not be run afterwards and gets only one driver
+    RequestDriver(crow::SimpleApp &givenApp);
+    ~RequestDriver();
+
+    // target is the path with an optional query, e.g. /api/board/search?q=x
+    crow::response send(crow::HTTPMethod method, std::string const &target, std::string const &body = "",
+                        crow::ci_map const &headers = crow::ci_map());
+
+    crow::response get(std::string const &target, crow::ci_map const &headers = crow::ci_map());
+    crow::response post(std::string const &target, std::string const &body, crow::ci_map const &headers = crow::ci_map());
+    crow::response put(std::string const &target, std::string const &body, crow::ci_map const &headers = crow::ci_map());
+    crow::response remove(std::string const &target, crow::ci_map const &headers = crow::ci_map());
+
+  private:
+    crow::SimpleApp &app;
+};
+
+} // namespace Api
+} // namespace Prog3
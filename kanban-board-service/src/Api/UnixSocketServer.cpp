@@ -0,0 +1,238 @@
+#include "UnixSocketServer.hpp"
+
+#ifdef KANBAN_HAS_UNIX_SOCKET
+
+#include <algorithm>
+#include <csignal>
+#include <ctime>
+#include <filesystem>
+#include <sys/stat.h>
+#include <thread>
+#include <tuple>
+
+using namespace Prog3::Api;
+using namespace crow;
+using namespace std;
+
+using LocalProtocol = boost::asio::local::stream_protocol;
+
+namespace {
+
+// crow's SocketAdaptor for a local socket
+struct UnixSocketAdaptor {
+    using context = void;
+
+    UnixSocketAdaptor(boost::asio::io_service &ioService, context *) : localSocket(ioService) {
+    }
+
+    boost::asio::io_service &get_io_service() {
+        return GET_IO_SERVICE(localSocket);
+    }
+
+    LocalProtocol::socket &raw_socket() {
+        return localSocket;
+    }
+
+    LocalProtocol::socket &socket() {
+        return localSocket;
+    }
+
+    // only used for the request log, the peer of a local socket has no name anyway
+    LocalProtocol::endpoint remote_endpoint() {
+        boost::system::error_code ignored;
+        return localSocket.remote_endpoint(ignored);
+    }
+
+    bool is_open() {
+        return localSocket.is_open();
+    }
+
+    void close() {
+        boost::system::error_code ignored;
+        localSocket.close(ignored);
+    }
+
+    template <typename F>
+    void start(F f) {
+        f(boost::system::error_code());
+    }
+
+    LocalProtocol::socket localSocket;
+};
+
+// the app's router for crow's connection, there are no websocket routes to upgrade to
+struct RouteHandler {
+    SimpleApp &app;
+
+    void handle(request const &req, response &res) {
+        app.handle(req, res);
+    }
+
+    template <typename Adaptor>
+    void handle_upgrade(request const &, response &res, Adaptor &&) {
+        res = response(404);
+        res.end();
+    }
+};
+
+using UnixConnection = Connection<UnixSocketAdaptor, RouteHandler>;
+
+} // namespace
+
+// one thread with its own io_service, as crow runs its tcp connections
+struct UnixSocketServer::Worker {
+    Worker(SimpleApp &app) : handler{app}, work(io), timer(io) {
+        timerQueue.set_io_service(io);
+        getDate = [lastUpdate = std::time_t(0), date = std::string()]() mutable {
+            std::time_t now = std::time(nullptr);
+            if (now != lastUpdate) {
+                std::tm utc;
+                gmtime_r(&now, &utc);
+                char buffer[64];
+                date.assign(buffer, std::strftime(buffer, sizeof(buffer), "%a, %d %b %Y %H:%M:%S GMT", &utc));
+                lastUpdate = now;
+            }
+            return date;
+        };
+    }
+
+    boost::asio::io_service io;
+    RouteHandler handler;
+    boost::asio::io_service::work work;
+    // runs the keep-alive timeouts of the connections once a second
+    boost::asio::deadline_timer timer;
+    crow::detail::dumb_timer_queue timerQueue;
+    // the connections keep references to these
+    std::function<std::string()> getDate;
+    std::string serverName = "Crow/0.1";
+    std::tuple<> middlewares;
+    std::thread thread;
+};
+
+UnixSocketServer::UnixSocketServer(SimpleApp &givenApp, UnixSocketOptions givenOptions) : app(givenApp), options(givenOptions) {
+}
+
+UnixSocketServer::~UnixSocketServer() {
+    stop();
+}
+
+bool UnixSocketServer::start() {
+    if (acceptor) {
+        return true;
+    }
+
+    // a socket file left behind by a previous run would fail the bind
+    std::error_code ignored;
+    if (std::filesystem::is_socket(options.path, ignored)) {
+        std::filesystem::remove(options.path, ignored);
+    }
+
+    for (int i = 0; i < std::max(1, options.threads); i++) {
+        workers.push_back(std::make_unique<Worker>(app));
+    }
+
+    acceptor = std::make_unique<LocalProtocol::acceptor>(workers.front()->io);
+    LocalProtocol::endpoint endpoint(options.path);
+    boost::system::error_code error;
+
+    acceptor->open(endpoint.protocol(), error);
+    if (!error) {
+        acceptor->bind(endpoint, error);
+    }
+    if (!error) {
+        acceptor->listen(boost::asio::socket_base::max_listen_connections, error);
+    }
+    if (error) {
+        CROW_LOG_ERROR << "Cannot listen on " << options.path << ": " << error.message();
+        acceptor.reset();
+        workers.clear();
+        return false;
+    }
+
+    if (chmod(options.path.c_str(), static_cast<mode_t>(options.mode)) != 0) {
+        CROW_LOG_WARNING << "Cannot set the mode of " << options.path;
+    }
+
+    for (auto &worker : workers) {
+        tick(*worker);
+        worker->thread = std::thread([&io = worker->io]() {
+            while (true) {
+                try {
+                    io.run();
+                    break;
+                } catch (std::exception const &e) {
+                    CROW_LOG_ERROR << "Worker Crash: An uncaught exception occurred: " << e.what();
+                }
+            }
+        });
+    }
+
+    accept();
+    CROW_LOG_INFO << "Listening on " << options.path << " using " << workers.size() << " threads";
+    return true;
+}
+
+void UnixSocketServer::stop() {
+    if (!acceptor) {
+        return;
+    }
+
+    for (auto &worker : workers) {
+        worker->io.stop();
+    }
+    for (auto &worker : workers) {
+        worker->thread.join();
+    }
+
+    // open connections are dropped with their io_service, as crow does on exit
+    acceptor.reset();
+    workers.clear();
+
+    std::error_code ignored;
+    std::filesystem::remove(options.path, ignored);
+}
+
+bool UnixSocketServer::run() {
+    if (!start()) {
+        return false;
+    }
+
+    boost::asio::io_service signalService;
+    boost::asio::signal_set signals(signalService, SIGINT, SIGTERM);
+    signals.async_wait([](boost::system::error_code const &, int) {});
+    signalService.run();
+
+    stop();
+    return true;
+}
+
+void UnixSocketServer::accept() {
+    Worker &worker = *workers[nextWorker];
+    nextWorker = (nextWorker + 1) % workers.size();
+
+    auto connection = new UnixConnection(worker.io, &worker.handler, worker.serverName, &worker.middlewares, worker.getDate, worker.timerQueue, nullptr);
+    acceptor->async_accept(connection->socket(), [this, connection, &worker](boost::system::error_code error) {
+        if (error) {
+            delete connection;
+        } else {
+            worker.io.post([connection]() { connection->start(); });
+        }
+
+        if (error != boost::asio::error::operation_aborted) {
+            accept();
+        }
+    });
+}
+
+void UnixSocketServer::tick(Worker &worker) {
+    worker.timer.expires_from_now(boost::posix_time::seconds(1));
+    worker.timer.async_wait([this, &worker](boost::system::error_code const &error) {
+        if (error) {
+            return;
+        }
+        worker.timerQueue.process();
+        tick(worker);
+    });
+}
+
+#endif
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "crow.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+// local sockets, chmod() and gmtime_r() are posix only. Without them there is
+// no UnixSocketServer, the options are still read so that the service can warn
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS) && !defined(_WIN32)
+#define KANBAN_HAS_UNIX_SOCKET
+#endif
+
+namespace Prog3 {
+namespace Api {
+
+struct UnixSocketOptions {
+    // empty: no unix socket listener
+    std::string path;
+    int threads = 1;
+    // the proxy usually runs as another user of the same group
+    long mode = 0660;
+};
+
+#ifdef KANBAN_HAS_UNIX_SOCKET
+
+// Serves the routes of an app on a unix domain socket, for a reverse proxy on
+// the same host. crow's own server only listens on tcp, this one accepts on a
+// local socket and hands the connections to crow's http connection, so both
+// listeners answer the same. It runs next to app.run() or on its own.
+class UnixSocketServer {
+  public:
+    UnixSocketServer(crow::SimpleApp &givenApp, UnixSocketOptions givenOptions);
+    ~UnixSocketServer();
+
+    // binds the socket and starts the threads, false if the socket cannot be bound
+    bool start();
+    void stop();
+    // start() and serve until SIGINT or SIGTERM, for running without the tcp listener.
+    // false if the socket cannot be bound
+    bool run();
+
+  private:
+    struct Worker;
+
+    crow::SimpleApp &app;
+    UnixSocketOptions options;
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::unique_ptr<boost::asio::local::stream_protocol::acceptor> acceptor;
+    unsigned nextWorker = 0;
+
+    void accept();
+    void tick(Worker &worker);
+};
+
+#endif
+
+} // namespace Api
+} // namespace Prog3
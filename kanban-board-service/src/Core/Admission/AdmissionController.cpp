@@ -0,0 +1,110 @@
+#include "AdmissionController.hpp"
+#include <algorithm>
+
+using namespace Prog3::Core::Admission;
+using namespace Prog3::Core::Metrics;
+
+AdmissionController::AdmissionController(MetricsRegistry &givenMetrics, AdmissionOptions givenOptions)
+    : metrics(givenMetrics), options(givenOptions) {
+
+    ClassState &reads = states[static_cast<int>(RequestClass::Read)];
+    reads.name = "read";
+    reads.maxLimit = std::max(options.maxReads, options.minLimit);
+    reads.limit = reads.maxLimit;
+
+    ClassState &writes = states[static_cast<int>(RequestClass::Write)];
+    writes.name = "write";
+    writes.maxLimit = std::max(options.maxWrites, options.minLimit);
+    writes.limit = writes.maxLimit;
+
+    for (auto const &state : states)
+        publishLimit(state);
+}
+
+AdmissionController::Permit AdmissionController::tryAcquire(RequestClass requestClass) {
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        ClassState &state = states[static_cast<int>(requestClass)];
+
+        if (state.inFlight < static_cast<int>(state.limit)) {
+            state.inFlight++;
+            return Permit(this, requestClass);
+        }
+    }
+
+    metrics.incrementCounter(MetricsRegistry::withLabel("kanban_admission_rejected_total", "class", states[static_cast<int>(requestClass)].name));
+    return Permit();
+}
+
+int AdmissionController::getLimit(RequestClass requestClass) {
+    std::lock_guard<std::mutex> lock(stateMutex);
+
+    return static_cast<int>(states[static_cast<int>(requestClass)].limit);
+}
+
+void AdmissionController::release(RequestClass requestClass, std::chrono::steady_clock::time_point started) {
+    auto now = std::chrono::steady_clock::now();
+    bool limitChanged = false;
+    ClassState published;
+
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        ClassState &state = states[static_cast<int>(requestClass)];
+        int previousLimit = static_cast<int>(state.limit);
+
+        state.inFlight--;
+
+        if (now - started > options.targetLatency) {
+            // one decrease per target latency: the requests of one slow burst
+            // all finish late, they should not collapse the limit together
+            if (now - state.lastDecrease > options.targetLatency) {
+                state.limit = std::max<double>(options.minLimit, state.limit * 0.9);
+                state.lastDecrease = now;
+            }
+        } else {
+            state.limit = std::min<double>(state.maxLimit, state.limit + 1.0 / state.limit);
+        }
+
+        limitChanged = static_cast<int>(state.limit) != previousLimit;
+        if (limitChanged) {
+            published = state;
+        }
+    }
+
+    if (limitChanged) {
+        publishLimit(published);
+    }
+}
+
+void AdmissionController::publishLimit(ClassState const &state) {
+    metrics.setGauge(MetricsRegistry::withLabel("kanban_admission_limit", "class", state.name), static_cast<int>(state.limit));
+}
+
+AdmissionController::Permit::Permit(AdmissionController *givenController, RequestClass givenRequestClass)
+    : controller(givenController), requestClass(givenRequestClass), started(std::chrono::steady_clock::now()) {
+}
+
+AdmissionController::Permit::Permit(Permit &&other)
+    : controller(other.controller), requestClass(other.requestClass), started(other.started) {
+    other.controller = nullptr;
+}
+
+AdmissionController::Permit &AdmissionController::Permit::operator=(Permit &&other) {
+    if (this != &other) {
+        if (controller) {
+            controller->release(requestClass, started);
+        }
+        controller = other.controller;
+        requestClass = other.requestClass;
+        started = other.started;
+        other.controller = nullptr;
+    }
+
+    return *this;
+}
+
+AdmissionController::Permit::~Permit() {
+    if (controller) {
+        controller->release(requestClass, started);
+    }
+}
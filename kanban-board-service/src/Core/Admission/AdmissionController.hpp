@@ -0,0 +1,86 @@
+#pragma once
+
+#include "Core/Metrics/MetricsRegistry.hpp"
+#include <array>
+#include <chrono>
+#include <mutex>
+#include <string>
+
+namespace Prog3 {
+namespace Core {
+namespace Admission {
+
+enum class RequestClass {
+    Read,
+    Write
+};
+
+struct AdmissionOptions {
+    // upper bounds of the adaptive limits, also the limits at start. limits
+    // above the number of threads running handlers never shed anything
+    int maxReads = 64;
+    int maxWrites = 16;
+    int minLimit = 1;
+    // a class whose requests take longer than this gets a lower limit
+    std::chrono::milliseconds targetLatency{100};
+};
+
+// Bounds the requests in flight per class. The limits adapt to the observed
+// latency (additive increase, multiplicative decrease): while requests finish
+// within the target a limit grows by about one per limit requests, a slow
+// request shrinks it by 10%, at most once per target latency.
+class AdmissionController {
+  private:
+    struct ClassState {
+        std::string name;
+        int inFlight = 0;
+        int maxLimit = 0;
+        double limit = 0;
+        std::chrono::steady_clock::time_point lastDecrease;
+    };
+
+    Prog3::Core::Metrics::MetricsRegistry &metrics;
+    AdmissionOptions options;
+
+    std::mutex stateMutex;
+    std::array<ClassState, 2> states;
+
+    void release(RequestClass requestClass, std::chrono::steady_clock::time_point started);
+    void publishLimit(ClassState const &state);
+
+  public:
+    // held while a request runs, releasing it reports the request's latency
+    class Permit {
+      private:
+        AdmissionController *controller;
+        RequestClass requestClass;
+        std::chrono::steady_clock::time_point started;
+
+      public:
+        Permit() : controller(nullptr), requestClass(RequestClass::Read) {}
+        Permit(AdmissionController *givenController, RequestClass givenRequestClass);
+        Permit(Permit &&other);
+        Permit &operator=(Permit &&other);
+        Permit(Permit const &) = delete;
+        Permit &operator=(Permit const &) = delete;
+        ~Permit();
+
+        explicit operator bool() const {
+            return controller != nullptr;
+        }
+    };
+
+    AdmissionController(Prog3::Core::Metrics::MetricsRegistry &givenMetrics, AdmissionOptions givenOptions);
+    ~AdmissionController() {}
+
+    // an empty permit means the class is at its limit and the request should be shed
+    Permit tryAcquire(RequestClass requestClass);
+
+    int getLimit(RequestClass requestClass);
+
+    static inline int const RETRY_AFTER_SECONDS = 1;
+};
+
+} // namespace Admission
+} // namespace Core
+} // namespace Prog3
@@ -0,0 +1,58 @@
+#include "BoardDirectory.hpp"
+
+using namespace Prog3::Core;
+
+BoardDirectory::BoardDirectory(BoardManager::ParserType &givenParser, RepositoryProvider givenRepositoryProvider)
+    : parser(givenParser), repositoryProvider(givenRepositoryProvider) {
+}
+
+BoardManager *BoardDirectory::getBoardManager(int boardId) {
+    return getBoardManager(boardId, false);
+}
+
+BoardManager &BoardDirectory::createBoardManager(int boardId) {
+    return *getBoardManager(boardId, true);
+}
+
+void BoardDirectory::forEachBoardManager(std::function<void(int boardId, BoardManager &boardManager)> const &action) {
+    std::vector<std::pair<int, BoardManager *>> currentManagers;
+    {
+        std::shared_lock<std::shared_mutex> lock(managersMutex);
+        for (auto &entry : managers)
+            currentManagers.emplace_back(entry.first, entry.second.get());
+    }
+
+    for (auto &entry : currentManagers)
+        action(entry.first, *entry.second);
+}
+
+BoardManager *BoardDirectory::getBoardManager(int boardId, bool create) {
+    {
+        std::shared_lock<std::shared_mutex> lock(managersMutex);
+
+        auto existing = managers.find(boardId);
+        if (existing != managers.end()) {
+            return existing->second.get();
+        }
+    }
+
+    // opening a board may take a while, the provider is asked without holding
+    // managersMutex so requests to other boards are not held up
+    BoardManager::RepositoryType *repository = repositoryProvider(boardId, create);
+    if (!repository) {
+        return nullptr;
+    }
+
+    std::unique_lock<std::shared_mutex> lock(managersMutex);
+
+    auto existing = managers.find(boardId);
+    if (existing != managers.end()) {
+        return existing->second.get();
+    }
+
+    auto manager = std::make_unique<BoardManager>(parser, *repository);
+    auto inserted = manager.get();
+    managers.emplace(boardId, std::move(manager));
+
+    return inserted;
+}
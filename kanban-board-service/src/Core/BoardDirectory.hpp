@@ -0,0 +1,45 @@
+#pragma once
+
+#include "BoardManager.hpp"
+#include <functional>
+#include <map>
+#include <mutex>
+#include <memory>
+#include <shared_mutex>
+#include <vector>
+
+namespace Prog3 {
+namespace Core {
+
+// Hands out one BoardManager per board id. Where a board is stored, and
+// whether it exists, is up to the repository provider, the directory only
+// keeps the managers alive.
+class BoardDirectory {
+  public:
+    // nullptr for a board that does not exist, unless create is set
+    using RepositoryProvider = std::function<BoardManager::RepositoryType *(int boardId, bool create)>;
+
+  private:
+    BoardManager::ParserType &parser;
+    RepositoryProvider repositoryProvider;
+
+    std::shared_mutex managersMutex;
+    std::map<int, std::unique_ptr<BoardManager>> managers;
+
+  public:
+    BoardDirectory(BoardManager::ParserType &givenParser, RepositoryProvider givenRepositoryProvider);
+    ~BoardDirectory() {}
+
+    // nullptr if the board does not exist
+    BoardManager *getBoardManager(int boardId);
+    BoardManager &createBoardManager(int boardId);
+    // every board that has a manager so far. action runs without holding
+    // managersMutex, managers are never removed
+    void forEachBoardManager(std::function<void(int boardId, BoardManager &boardManager)> const &action);
+
+  private:
+    BoardManager *getBoardManager(int boardId, bool create);
+};
+
+} // namespace Core
+} // namespace Prog3
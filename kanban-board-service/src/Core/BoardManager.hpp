@@ -1,32 +1,388 @@
 #pragma once
 
+#include "Api/Parser/JsonParser.hpp"
 #include "Api/Parser/ParserIf.hpp"
 #include "Repository/RepositoryIf.hpp"
+#include "Repository/SQLite/BoardRepository.hpp"
+#include "BoardSnapshot.hpp"
+#include "Exception/DeadlineExceededException.hpp"
+#include "RequestContext.hpp"
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <set>
 
 namespace Prog3 {
 namespace Core {
-class BoardManager {
+
+// The use cases of one board, parametrized by the parser and the repository.
+// Instantiated with the concrete (final) JsonParser and BoardRepository every
+// call is statically dispatched and can be inlined; instantiated with ParserIf
+// and RepositoryIf it accepts any implementation, e.g. mocks in tests.
+template <typename Parser, typename Repository>
+class BasicBoardManager {
+  public:
+    using ParserType = Parser;
+    using RepositoryType = Repository;
+
   private:
-    Prog3::Repository::RepositoryIf &repository;
-    Prog3::Api::Parser::ParserIf &parser;
+    Repository &repository;
+    Parser &parser;
+
+    // published with std::atomic_store and read with std::atomic_load only.
+    // readers take it as it is, writers replace it before they answer and
+    // pickUpOutsideWrites for commits made behind the service's back. only
+    // the very first read of the board builds it. replaced under refreshMutex
+    std::shared_ptr<BoardSnapshot const> snapshot;
+    std::mutex refreshMutex;
+
+    std::shared_ptr<BoardSnapshot const> getSnapshot();
+    // with refreshMutex held
+    std::shared_ptr<BoardSnapshot const> refreshSnapshot();
+    void refreshAfterWrite();
+
+    static int clampPageLimit(int limit);
 
   public:
-    BoardManager(Prog3::Api::Parser::ParserIf &givenParser, Prog3::Repository::RepositoryIf &givenRepository);
-    ~BoardManager();
+    BasicBoardManager(Parser &givenParser, Repository &givenRepository);
+    ~BasicBoardManager() {}
 
     std::string getBoard();
     std::string getColumns();
-    std::string getColumn(int columnId);
+    std::string getColumn(std::int64_t columnId);
     std::string postColumn(std::string request);
-    std::string putColumn(int columnId, std::string request);
-    void deleteColumn(int columnId);
-
-    std::string getItems(int columnId);
-    std::string getItem(int columnId, int itemId);
-    std::string postItem(int columnId, std::string request);
-    std::string putItem(int columnId, int itemId, std::string request);
-    void deleteItem(int columnId, int itemId);
+    std::string putColumn(std::int64_t columnId, std::string request);
+    void deleteColumn(std::int64_t columnId);
+
+    std::string getItems(std::int64_t columnId);
+    std::string getItem(std::int64_t columnId, std::int64_t itemId);
+    std::string postItem(std::int64_t columnId, std::string request);
+    std::string putItem(std::int64_t columnId, std::int64_t itemId, std::string request);
+    void deleteItem(std::int64_t columnId, std::int64_t itemId);
+
+    std::string getChanges(std::int64_t sinceVersion);
+    std::string searchItems(std::string query, int limit, int offset);
+    std::string getArchivedItems(int limit, int offset);
+
+    // replaces the snapshot if the board has changed since, e.g. by a script
+    // writing the file. called periodically, off the read path
+    void pickUpOutsideWrites();
+
+    static inline int const DEFAULT_PAGE_LIMIT = 20;
+    static inline int const MAX_PAGE_LIMIT = 100;
 };
 
+using InterfaceBoardManager = BasicBoardManager<Prog3::Api::Parser::ParserIf, Prog3::Repository::RepositoryIf>;
+
+// the service is built against the concrete types unless KANBAN_VIRTUAL_DISPATCH is set
+#ifdef KANBAN_VIRTUAL_DISPATCH
+using BoardManager = InterfaceBoardManager;
+#else
+using BoardManager = BasicBoardManager<Prog3::Api::Parser::JsonParser, Prog3::Repository::SQLite::BoardRepository>;
+#endif
+
+template <typename Parser, typename Repository>
+BasicBoardManager<Parser, Repository>::BasicBoardManager(Parser &givenParser, Repository &givenRepository)
+    : repository(givenRepository), parser(givenParser) {
+}
+
+template <typename Parser, typename Repository>
+std::string BasicBoardManager<Parser, Repository>::getBoard() {
+    return getSnapshot()->boardJson;
+}
+
+template <typename Parser, typename Repository>
+std::string BasicBoardManager<Parser, Repository>::getColumns() {
+    return getSnapshot()->columnsJson;
+}
+
+template <typename Parser, typename Repository>
+std::shared_ptr<BoardSnapshot const> BasicBoardManager<Parser, Repository>::getSnapshot() {
+    std::shared_ptr<BoardSnapshot const> current = std::atomic_load(&snapshot);
+
+    if (current) {
+        return current;
+    }
+
+    std::lock_guard<std::mutex> lock(refreshMutex);
+
+    // another reader may have built it while this one waited
+    current = std::atomic_load(&snapshot);
+    if (current) {
+        return current;
+    }
+
+    return refreshSnapshot();
+}
+
+template <typename Parser, typename Repository>
+std::shared_ptr<BoardSnapshot const> BasicBoardManager<Parser, Repository>::refreshSnapshot() {
+    std::shared_ptr<BoardSnapshot const> current = std::atomic_load(&snapshot);
+
+    std::optional<Prog3::Core::Model::ChangeSet> changes;
+    if (current) {
+        changes = repository.getChangesSince(current->version);
+    }
+
+    // no usable log (first load or compacted) or a column was added, renamed,
+    // moved or removed: the order may have changed, rebuild all columns
+    bool rebuild = !changes.has_value();
+    std::set<std::int64_t> touchedColumns;
+
+    if (changes) {
+        for (auto const &change : changes->getChanges()) {
+            if (change.getEntity() == Prog3::Core::Model::Change::Entity::Column) {
+                rebuild = true;
+            }
+            touchedColumns.insert(change.getColumnId());
+        }
+    }
+
+    auto next = std::make_shared<BoardSnapshot>();
+
+    if (rebuild) {
+        // the version is read first, writes racing the rebuild are applied again next time
+        next->version = repository.getVersion();
+        Prog3::Core::Model::Board board = repository.getBoard();
+        next->title = board.getTitle();
+
+        for (auto &column : board.getColumns()) {
+            next->columns.push_back(std::make_shared<Prog3::Core::Model::Column const>(column));
+            next->fragments.push_back(std::make_shared<std::string const>(parser.convertToApiString(column)));
+        }
+    } else {
+        next->version = changes->getVersion();
+        next->title = current->title;
+        next->columns = current->columns;
+        next->fragments = current->fragments;
+
+        for (std::int64_t columnId : touchedColumns) {
+            int index = current->findColumn(columnId);
+            if (index < 0) {
+                continue;
+            }
+
+            // a column deleted in the meantime stays until the next refresh
+            // sees the delete in the log and rebuilds
+            std::optional<Prog3::Core::Model::Column> column = repository.getColumn(columnId);
+            if (column) {
+                next->fragments[index] = std::make_shared<std::string const>(parser.convertToApiString(column.value()));
+                next->columns[index] = std::make_shared<Prog3::Core::Model::Column const>(std::move(column.value()));
+            }
+        }
+    }
+
+    next->boardJson = parser.assembleBoardApiString(next->title, next->fragments);
+    next->columnsJson = parser.assembleColumnsApiString(next->fragments);
+
+    std::shared_ptr<BoardSnapshot const> published = std::move(next);
+    std::atomic_store(&snapshot, published);
+
+    return published;
+}
+
+template <typename Parser, typename Repository>
+void BasicBoardManager<Parser, Repository>::refreshAfterWrite() {
+    std::lock_guard<std::mutex> lock(refreshMutex);
+
+    // nobody has read the board yet, the first reader builds it
+    if (!std::atomic_load(&snapshot)) {
+        return;
+    }
+
+    // the write itself is done and the reads after it have to see it, so the
+    // refresh is not cut short by the deadline of the write
+    RequestContext::Scope context(std::nullopt, RequestPriority::Write);
+
+    try {
+        refreshSnapshot();
+    } catch (std::exception const &) {
+        // the next read builds it from scratch instead of answering from before the write
+        std::atomic_store(&snapshot, std::shared_ptr<BoardSnapshot const>());
+    }
+}
+
+template <typename Parser, typename Repository>
+void BasicBoardManager<Parser, Repository>::pickUpOutsideWrites() {
+    std::shared_ptr<BoardSnapshot const> current = std::atomic_load(&snapshot);
+    if (!current || current->version == repository.peekVersion()) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(refreshMutex);
+    if (std::atomic_load(&snapshot)) {
+        refreshSnapshot();
+    }
+}
+
+template <typename Parser, typename Repository>
+std::string BasicBoardManager<Parser, Repository>::getColumn(std::int64_t columnId) {
+    std::shared_ptr<BoardSnapshot const> current = getSnapshot();
+
+    int index = current->findColumn(columnId);
+    if (index < 0) {
+        return parser.getEmptyResponseString();
+    }
+
+    return *current->fragments[index];
+}
+
+template <typename Parser, typename Repository>
+std::string BasicBoardManager<Parser, Repository>::postColumn(std::string request) {
+    int const dummyId = -1;
+    std::optional<Prog3::Core::Model::Column> parsedColumnOptional = parser.convertColumnToModel(dummyId, request);
+    if (!parsedColumnOptional.has_value()) {
+        return parser.getEmptyResponseString();
+    }
+
+    Prog3::Core::Model::Column parsedColumn = parsedColumnOptional.value();
+
+    std::optional<Prog3::Core::Model::Column> postedColumn = repository.postColumn(parsedColumn.getName(), parsedColumn.getPos());
+    refreshAfterWrite();
+
+    if (postedColumn) {
+        return parser.convertToApiString(postedColumn.value());
+    } else {
+        return parser.getEmptyResponseString();
+    }
+}
+
+template <typename Parser, typename Repository>
+std::string BasicBoardManager<Parser, Repository>::putColumn(std::int64_t columnId, std::string request) {
+
+    std::optional<Prog3::Core::Model::Column> parsedColumnOptional = parser.convertColumnToModel(columnId, request);
+
+    if (!parsedColumnOptional.has_value()) {
+        return parser.getEmptyResponseString();
+    }
+    Prog3::Core::Model::Column column = parsedColumnOptional.value();
+    std::optional<Prog3::Core::Model::Column> putColumn = repository.putColumn(columnId, column.getName(), column.getPos());
+    refreshAfterWrite();
+
+    if (putColumn) {
+        return parser.convertToApiString(putColumn.value());
+    } else {
+        return parser.getEmptyResponseString();
+    }
+}
+
+template <typename Parser, typename Repository>
+void BasicBoardManager<Parser, Repository>::deleteColumn(std::int64_t columnId) {
+    repository.deleteColumn(columnId);
+    refreshAfterWrite();
+}
+
+template <typename Parser, typename Repository>
+std::string BasicBoardManager<Parser, Repository>::getItems(std::int64_t columnId) {
+    std::shared_ptr<BoardSnapshot const> current = getSnapshot();
+
+    int index = current->findColumn(columnId);
+    if (index < 0) {
+        return parser.convertToApiString(std::vector<Prog3::Core::Model::Item>());
+    }
+
+    return parser.convertToApiString(current->columns[index]->getItems());
+}
+
+template <typename Parser, typename Repository>
+std::string BasicBoardManager<Parser, Repository>::getItem(std::int64_t columnId, std::int64_t itemId) {
+    std::shared_ptr<BoardSnapshot const> current = getSnapshot();
+
+    int index = current->findColumn(columnId);
+    if (index >= 0) {
+        for (auto const &item : current->columns[index]->getItems()) {
+            if (item.getId() == itemId) {
+                return parser.convertToApiString(item);
+            }
+        }
+    }
+
+    return parser.getEmptyResponseString();
+}
+
+template <typename Parser, typename Repository>
+std::string BasicBoardManager<Parser, Repository>::postItem(std::int64_t columnId, std::string request) {
+    int const dummyId = -1;
+    std::optional parsedItemOptional = parser.convertItemToModel(dummyId, request);
+    if (false == parsedItemOptional.has_value()) {
+        return parser.getEmptyResponseString();
+    }
+
+    Prog3::Core::Model::Item item = parsedItemOptional.value();
+    std::optional<Prog3::Core::Model::Item> postedItem = repository.postItem(columnId, std::string(item.getTitle()), item.getPos());
+    refreshAfterWrite();
+    if (postedItem) {
+        return parser.convertToApiString(postedItem.value());
+    } else {
+        return parser.getEmptyResponseString();
+    }
+}
+
+template <typename Parser, typename Repository>
+std::string BasicBoardManager<Parser, Repository>::putItem(std::int64_t columnId, std::int64_t itemId, std::string request) {
+
+    std::optional parsedItemOptional = parser.convertItemToModel(itemId, request);
+    if (!parsedItemOptional.has_value()) {
+        return parser.getEmptyResponseString();
+    }
+
+    Prog3::Core::Model::Item item = parsedItemOptional.value();
+    std::optional<Prog3::Core::Model::Item> putItem = repository.putItem(columnId, itemId, std::string(item.getTitle()), item.getPos());
+    refreshAfterWrite();
+
+    if (putItem) {
+        return parser.convertToApiString(putItem.value());
+    } else {
+        return parser.getEmptyResponseString();
+    }
+}
+
+template <typename Parser, typename Repository>
+void BasicBoardManager<Parser, Repository>::deleteItem(std::int64_t columnId, std::int64_t itemId) {
+    repository.deleteItem(columnId, itemId);
+    refreshAfterWrite();
+}
+
+template <typename Parser, typename Repository>
+std::string BasicBoardManager<Parser, Repository>::getChanges(std::int64_t sinceVersion) {
+    std::optional<Prog3::Core::Model::ChangeSet> changes = repository.getChangesSince(sinceVersion);
+
+    if (changes) {
+        return parser.convertToApiString(changes.value());
+    }
+
+    // the version has been compacted away (or never existed): full resync.
+    // read the version first, a write slipping in before the board is read
+    // is then just replayed by the client's next delta request
+    std::int64_t version = repository.getVersion();
+    Prog3::Core::Model::Board board = repository.getBoard();
+
+    return parser.convertToApiString(board, version);
+}
+
+template <typename Parser, typename Repository>
+std::string BasicBoardManager<Parser, Repository>::searchItems(std::string query, int limit, int offset) {
+    std::vector<Prog3::Core::Model::SearchHit> hits = repository.searchItems(query, clampPageLimit(limit), std::max(offset, 0));
+
+    return parser.convertToApiString(hits);
+}
+
+template <typename Parser, typename Repository>
+std::string BasicBoardManager<Parser, Repository>::getArchivedItems(int limit, int offset) {
+    std::vector<Prog3::Core::Model::ArchivedItem> archivedItems = repository.getArchivedItems(clampPageLimit(limit), std::max(offset, 0));
+
+    return parser.convertToApiString(archivedItems);
+}
+
+template <typename Parser, typename Repository>
+int BasicBoardManager<Parser, Repository>::clampPageLimit(int limit) {
+    if (limit <= 0) {
+        return DEFAULT_PAGE_LIMIT;
+    }
+
+    return std::min(limit, MAX_PAGE_LIMIT);
+}
+
 } // namespace Core
 } // namespace Prog3
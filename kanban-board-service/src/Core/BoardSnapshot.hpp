@@ -0,0 +1,42 @@
+#pragma once
+
+#include "Api/Parser/ParserIf.hpp"
+#include "Core/Model/Column.hpp"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Prog3 {
+namespace Core {
+
+// One board as of a change_log version, serialized and as model. Never
+// changed once published: the next version copies the vector of column
+// pointers and replaces only the columns whose items changed, all others are
+// shared with the previous snapshot.
+struct BoardSnapshot {
+    std::int64_t version = 0;
+    std::string title;
+
+    // by position, fragments[i] is columns[i] serialized
+    std::vector<std::shared_ptr<Prog3::Core::Model::Column const>> columns;
+    Prog3::Api::Parser::ParserIf::ColumnFragments fragments;
+
+    // responses of /api/board and /api/board/columns
+    std::string boardJson;
+    std::string columnsJson;
+
+    // -1 if there is no such column
+    int findColumn(std::int64_t columnId) const {
+        for (size_t i = 0; i < columns.size(); i++) {
+            if (columns[i]->getId() == columnId) {
+                return static_cast<int>(i);
+            }
+        }
+
+        return -1;
+    }
+};
+
+} // namespace Core
+} // namespace Prog3
@@ -0,0 +1,169 @@
+#include "Configuration.hpp"
+#include "rapidjson/error/en.h"
+#include "rapidjson/istreamwrapper.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <sstream>
+
+using namespace Prog3::Core;
+using namespace rapidjson;
+using namespace std;
+
+Configuration::Configuration() {
+    document.SetObject();
+}
+
+bool Configuration::load(std::string const &givenFile) {
+    std::ifstream stream(givenFile);
+    if (!stream) {
+        cout << "Cannot read configuration " << givenFile << endl;
+        return false;
+    }
+
+    IStreamWrapper wrapper(stream);
+    Document loaded;
+    loaded.ParseStream(wrapper);
+
+    if (loaded.HasParseError()) {
+        cout << "Cannot parse configuration " << givenFile << " at offset " << loaded.GetErrorOffset() << ": "
+             << GetParseError_En(loaded.GetParseError()) << endl;
+        return false;
+    }
+    if (!loaded.IsObject()) {
+        cout << "Configuration " << givenFile << " is not a JSON object" << endl;
+        return false;
+    }
+
+    document.Swap(loaded);
+    file = givenFile;
+    return true;
+}
+
+std::string const &Configuration::getFile() const {
+    return file;
+}
+
+std::string Configuration::getString(char const *path, char const *environmentName, std::string const &fallback) const {
+    std::string value;
+    std::string source;
+
+    return lookup(path, environmentName, value, source) ? value : fallback;
+}
+
+long Configuration::getLong(char const *path, char const *environmentName, long fallback) const {
+    return getLong(path, environmentName, fallback, std::numeric_limits<long>::min());
+}
+
+long Configuration::getLong(char const *path, char const *environmentName, long fallback, long minimum) const {
+    std::string value;
+    std::string source;
+    if (!lookup(path, environmentName, value, source)) {
+        return fallback;
+    }
+
+    try {
+        std::size_t parsed = 0;
+        long number = std::stol(value, &parsed);
+        if (parsed == value.size() && number >= minimum) {
+            return number;
+        }
+        if (parsed == value.size()) {
+            cout << "Ignoring " << source << " below " << minimum << ", using " << fallback << endl;
+            return fallback;
+        }
+    } catch (std::exception const &) {
+    }
+
+    cout << "Ignoring invalid value of " << source << ", using " << fallback << endl;
+    return fallback;
+}
+
+long Configuration::getOctal(char const *path, char const *environmentName, long fallback) const {
+    std::string value;
+    std::string source;
+    if (!lookup(path, environmentName, value, source)) {
+        return fallback;
+    }
+
+    try {
+        std::size_t parsed = 0;
+        long number = std::stol(value, &parsed, 8);
+        if (parsed == value.size()) {
+            return number;
+        }
+    } catch (std::exception const &) {
+    }
+
+    cout << "Ignoring invalid value of " << source << ", using " << std::oct << fallback << std::dec << endl;
+    return fallback;
+}
+
+std::string Configuration::getChoice(char const *path, char const *environmentName, std::vector<std::string> const &choices,
+                                     std::string const &fallback) const {
+    std::string value;
+    std::string source;
+    if (!lookup(path, environmentName, value, source)) {
+        return fallback;
+    }
+
+    std::transform(value.begin(), value.end(), value.begin(), [](unsigned char c) { return std::tolower(c); });
+    if (std::find(choices.begin(), choices.end(), value) != choices.end()) {
+        return value;
+    }
+
+    cout << "Ignoring invalid value of " << source << ", using " << fallback << endl;
+    return fallback;
+}
+
+Value const *Configuration::find(std::string const &path) const {
+    Value const *value = &document;
+    std::istringstream keys(path);
+    std::string key;
+
+    while (std::getline(keys, key, '.')) {
+        if (!value->IsObject()) {
+            return nullptr;
+        }
+
+        auto member = value->FindMember(key.c_str());
+        if (member == value->MemberEnd()) {
+            return nullptr;
+        }
+        value = &member->value;
+    }
+
+    return value;
+}
+
+bool Configuration::lookup(char const *path, char const *environmentName, std::string &value, std::string &source) const {
+    char const *environmentValue = std::getenv(environmentName);
+    if (environmentValue) {
+        value = environmentValue;
+        source = environmentName;
+        return true;
+    }
+
+    Value const *fileValue = find(path);
+    if (!fileValue || fileValue->IsNull()) {
+        return false;
+    }
+
+    source = path;
+    if (fileValue->IsString()) {
+        value = fileValue->GetString();
+    } else if (fileValue->IsBool()) {
+        value = fileValue->GetBool() ? "1" : "0";
+    } else if (fileValue->IsInt64()) {
+        value = std::to_string(fileValue->GetInt64());
+    } else {
+        // e.g. 1.5 or an array, no setting takes those
+        cout << "Ignoring invalid value of " << path << endl;
+        return false;
+    }
+
+    return true;
+}
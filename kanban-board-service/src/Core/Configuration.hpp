@@ -0,0 +1,44 @@
+#pragma once
+
+#include "rapidjson/document.h"
+#include <string>
+#include <vector>
+
+namespace Prog3 {
+namespace Core {
+
+// Startup settings of the service, read from an optional JSON file and
+// overridden by environment variables. A setting is looked up by its path in
+// the file, e.g. "storage.cacheSize" for {"storage": {"cacheSize": -65536}},
+// and by the name of its variable. Invalid values are reported and skipped.
+class Configuration {
+  public:
+    Configuration();
+    ~Configuration() {}
+
+    // false if the file cannot be read or does not hold a JSON object
+    bool load(std::string const &givenFile);
+    std::string const &getFile() const;
+
+    std::string getString(char const *path, char const *environmentName, std::string const &fallback) const;
+    long getLong(char const *path, char const *environmentName, long fallback) const;
+    // for intervals, timeouts and other values with a lower bound, smaller values are invalid
+    long getLong(char const *path, char const *environmentName, long fallback, long minimum) const;
+    // file modes, written as a string in the file, e.g. "0660"
+    long getOctal(char const *path, char const *environmentName, long fallback) const;
+    // one of choices, for values that end up in sql or select a mode
+    std::string getChoice(char const *path, char const *environmentName, std::vector<std::string> const &choices,
+                          std::string const &fallback) const;
+
+  private:
+    std::string file;
+    rapidjson::Document document;
+
+    // the value at path in the file, nullptr if it is not set
+    rapidjson::Value const *find(std::string const &path) const;
+    // the variable if it is set, otherwise the file value as text, empty if neither is set
+    bool lookup(char const *path, char const *environmentName, std::string &value, std::string &source) const;
+};
+
+} // namespace Core
+} // namespace Prog3
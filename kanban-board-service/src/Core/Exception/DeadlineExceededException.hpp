@@ -0,0 +1,14 @@
+#pragma once
+
+#include <stdexcept>
+
+namespace Prog3 {
+namespace Core {
+namespace Exception {
+class DeadlineExceededException : public std::runtime_error {
+  public:
+    DeadlineExceededException() : std::runtime_error("Request deadline exceeded"){};
+};
+} // namespace Exception
+} // namespace Core
+} // namespace Prog3
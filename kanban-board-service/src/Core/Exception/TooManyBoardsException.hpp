@@ -0,0 +1,14 @@
+#pragma once
+
+#include <stdexcept>
+
+namespace Prog3 {
+namespace Core {
+namespace Exception {
+class TooManyBoardsException : public std::runtime_error {
+  public:
+    TooManyBoardsException() : std::runtime_error("Too many open boards"){};
+};
+} // namespace Exception
+} // namespace Core
+} // namespace Prog3
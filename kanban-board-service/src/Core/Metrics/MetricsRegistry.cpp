@@ -0,0 +1,65 @@
+#include "MetricsRegistry.hpp"
+#include <algorithm>
+#include <sstream>
+
+using namespace Prog3::Core::Metrics;
+
+void MetricsRegistry::setGauge(std::string const &name, double value) {
+    std::lock_guard<std::mutex> lock(metricsMutex);
+    gauges[name] = value;
+}
+
+void MetricsRegistry::incrementCounter(std::string const &name, double increment) {
+    std::lock_guard<std::mutex> lock(metricsMutex);
+    counters[name] += increment;
+}
+
+void MetricsRegistry::observe(std::string const &name, double value) {
+    std::lock_guard<std::mutex> lock(metricsMutex);
+
+    Summary &summary = summaries[name];
+    summary.count += 1;
+    summary.sum += value;
+    summary.max = (summary.count == 1) ? value : std::max(summary.max, value);
+}
+
+std::string MetricsRegistry::toText() {
+    std::lock_guard<std::mutex> lock(metricsMutex);
+    std::ostringstream text;
+    text.precision(15);
+
+    for (auto const &gauge : gauges)
+        text << gauge.first << " " << gauge.second << "\n";
+
+    for (auto const &counter : counters)
+        text << counter.first << " " << counter.second << "\n";
+
+    for (auto const &summary : summaries) {
+        text << withSuffix(summary.first, "_count") << " " << summary.second.count << "\n";
+        text << withSuffix(summary.first, "_sum") << " " << summary.second.sum << "\n";
+        text << withSuffix(summary.first, "_max") << " " << summary.second.max << "\n";
+    }
+
+    return text.str();
+}
+
+std::string MetricsRegistry::withLabel(std::string const &name, std::string const &label, std::string const &value) {
+    std::string labelPair = label + "=\"" + value + "\"";
+    auto labelsStart = name.find('{');
+
+    if (labelsStart == std::string::npos) {
+        return name + "{" + labelPair + "}";
+    }
+
+    return name.substr(0, name.size() - 1) + "," + labelPair + "}";
+}
+
+std::string MetricsRegistry::withSuffix(std::string const &name, std::string const &suffix) {
+    auto labelsStart = name.find('{');
+
+    if (labelsStart == std::string::npos) {
+        return name + suffix;
+    }
+
+    return name.substr(0, labelsStart) + suffix + name.substr(labelsStart);
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <map>
+#include <mutex>
+#include <string>
+
+namespace Prog3 {
+namespace Core {
+namespace Metrics {
+
+// Process wide numbers for the admin endpoint, rendered in the Prometheus
+// text format. Names may carry labels: "kanban_backup_progress{board=\"7\"}".
+class MetricsRegistry {
+  private:
+    struct Summary {
+        double count = 0;
+        double sum = 0;
+        double max = 0;
+    };
+
+    std::mutex metricsMutex;
+    std::map<std::string, double> gauges;
+    std::map<std::string, double> counters;
+    std::map<std::string, Summary> summaries;
+
+    static std::string withSuffix(std::string const &name, std::string const &suffix);
+
+  public:
+    MetricsRegistry() {}
+    ~MetricsRegistry() {}
+
+    void setGauge(std::string const &name, double value);
+    void incrementCounter(std::string const &name, double increment = 1);
+    // e.g. durations: exposed as <name>_count, <name>_sum and <name>_max
+    void observe(std::string const &name, double value);
+
+    std::string toText();
+
+    static std::string withLabel(std::string const &name, std::string const &label, std::string const &value);
+};
+
+} // namespace Metrics
+} // namespace Core
+} // namespace Prog3
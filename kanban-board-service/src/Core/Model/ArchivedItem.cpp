@@ -0,0 +1,22 @@
+#include "ArchivedItem.hpp"
+
+using namespace Prog3::Core::Model;
+
+ArchivedItem::ArchivedItem(Item const &givenItem, std::int64_t givenColumnId, std::string givenColumnName, std::int64_t givenArchivedAt)
+    : item(givenItem), columnId(givenColumnId), columnName(givenColumnName), archivedAt(givenArchivedAt) {}
+
+Item const &ArchivedItem::getItem() const {
+    return item;
+}
+
+std::int64_t ArchivedItem::getColumnId() const {
+    return columnId;
+}
+
+std::string const &ArchivedItem::getColumnName() const {
+    return columnName;
+}
+
+std::int64_t ArchivedItem::getArchivedAt() const {
+    return archivedAt;
+}
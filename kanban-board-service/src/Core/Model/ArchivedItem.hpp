@@ -0,0 +1,31 @@
+#pragma once
+
+#include "Item.hpp"
+#include <cstdint>
+#include <string>
+
+namespace Prog3 {
+namespace Core {
+namespace Model {
+
+class ArchivedItem {
+  public:
+    ArchivedItem(Item const &givenItem, std::int64_t givenColumnId, std::string givenColumnName, std::int64_t givenArchivedAt);
+    ~ArchivedItem() {}
+
+    Item const &getItem() const;
+    std::int64_t getColumnId() const;
+    std::string const &getColumnName() const;
+    // unix time in seconds
+    std::int64_t getArchivedAt() const;
+
+  private:
+    Item item;
+    std::int64_t columnId;
+    std::string columnName;
+    std::int64_t archivedAt;
+};
+
+} // namespace Model
+} // namespace Core
+} // namespace Prog3
@@ -4,7 +4,7 @@ using namespace Prog3::Core::Model;
 
 Board::Board(std::string givenTitle) : title(givenTitle) {}
 
-std::string Board::getTitle() const {
+std::string const &Board::getTitle() const {
     return title;
 }
 
@@ -14,7 +14,7 @@ class Board {
     Board(std::string givenTitle);
     ~Board() {}
 
-    std::string getTitle() const;
+    std::string const &getTitle() const;
 
     std::vector<Column> &getColumns();
     void setColumns(std::vector<Column> const &columns);
@@ -0,0 +1,42 @@
+#include "Change.hpp"
+
+using namespace Prog3::Core::Model;
+
+Change::Change(std::int64_t givenSequence, Entity givenEntity, Operation givenOperation, std::int64_t givenId, std::int64_t givenColumnId)
+    : sequence(givenSequence), entity(givenEntity), operation(givenOperation), id(givenId), columnId(givenColumnId) {}
+
+std::int64_t Change::getSequence() const {
+    return sequence;
+}
+
+Change::Entity Change::getEntity() const {
+    return entity;
+}
+
+Change::Operation Change::getOperation() const {
+    return operation;
+}
+
+std::int64_t Change::getId() const {
+    return id;
+}
+
+std::int64_t Change::getColumnId() const {
+    return columnId;
+}
+
+std::optional<Column> Change::getColumn() const {
+    return column;
+}
+
+std::optional<Item> Change::getItem() const {
+    return item;
+}
+
+void Change::setColumn(Column const &givenColumn) {
+    column = givenColumn;
+}
+
+void Change::setItem(Item const &givenItem) {
+    item = givenItem;
+}
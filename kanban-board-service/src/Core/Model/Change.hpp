@@ -0,0 +1,53 @@
+#pragma once
+
+#include "Column.hpp"
+#include "Item.hpp"
+#include <cstdint>
+#include <optional>
+
+namespace Prog3 {
+namespace Core {
+namespace Model {
+
+class Change {
+  public:
+    enum class Entity {
+        Column,
+        Item
+    };
+
+    enum class Operation {
+        Insert,
+        Update,
+        Delete
+    };
+
+    Change(std::int64_t givenSequence, Entity givenEntity, Operation givenOperation, std::int64_t givenId, std::int64_t givenColumnId);
+    ~Change() {}
+
+    std::int64_t getSequence() const;
+    Entity getEntity() const;
+    Operation getOperation() const;
+    std::int64_t getId() const;
+    std::int64_t getColumnId() const;
+
+    // the state after the change, empty for deletions
+    std::optional<Column> getColumn() const;
+    std::optional<Item> getItem() const;
+
+    void setColumn(Column const &givenColumn);
+    void setItem(Item const &givenItem);
+
+  private:
+    std::int64_t sequence;
+    Entity entity;
+    Operation operation;
+    std::int64_t id;
+    std::int64_t columnId;
+    std::optional<Column> column;
+    std::optional<Item> item;
+};
+
+} // namespace Model
+} // namespace Core
+} // namespace Prog3
@@ -0,0 +1,18 @@
+#include "ChangeSet.hpp"
+
+using namespace Prog3::Core::Model;
+
+ChangeSet::ChangeSet(std::int64_t givenVersion) : version(givenVersion) {}
+
+std::int64_t ChangeSet::getVersion() const {
+    return version;
+}
+
+std::vector<Change> &ChangeSet::getChanges() {
+    return changes;
+}
+
+void ChangeSet::addChange(Change const &change) {
+    changes.push_back(change);
+    version = change.getSequence();
+}
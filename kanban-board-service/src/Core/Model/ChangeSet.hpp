@@ -0,0 +1,29 @@
+#pragma once
+
+#include "Change.hpp"
+#include <cstdint>
+#include <vector>
+
+namespace Prog3 {
+namespace Core {
+namespace Model {
+
+class ChangeSet {
+  public:
+    ChangeSet(std::int64_t givenVersion);
+    ~ChangeSet() {}
+
+    // sequence number of the newest change the set accounts for
+    std::int64_t getVersion() const;
+    std::vector<Change> &getChanges();
+
+    void addChange(Change const &change);
+
+  private:
+    std::int64_t version;
+    std::vector<Change> changes;
+};
+
+} // namespace Model
+} // namespace Core
+} // namespace Prog3
@@ -5,14 +5,14 @@ using namespace Prog3::Core::Model;
 Column::Column()
     : id(-1) {}
 
-Column::Column(int id, std::string givenName, int givenPosition)
+Column::Column(std::int64_t id, std::string givenName, int givenPosition)
     : id(id), name(givenName), position(givenPosition) {}
 
-int Column::getId() const {
+std::int64_t Column::getId() const {
     return id;
 }
 
-std::string Column::getName() const {
+std::string const &Column::getName() const {
     return name;
 }
 
@@ -20,11 +20,11 @@ int Column::getPos() const {
     return position;
 }
 
-std::vector<Item> Column::getItems() const {
+std::vector<Item> const &Column::getItems() const {
     return items;
 }
 
-void Column::setID(int givenId) {
+void Column::setID(std::int64_t givenId) {
     id = givenId;
 }
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Item.hpp"
+#include <cstdint>
 #include <iostream>
 #include <string>
 #include <vector>
@@ -13,21 +14,21 @@ namespace Model {
 class Column {
   public:
     Column();
-    Column(int id, std::string givenName, int givenPosition);
+    Column(std::int64_t id, std::string givenName, int givenPosition);
     ~Column(){};
 
-    int getId() const;
-    std::string getName() const;
+    std::int64_t getId() const;
+    std::string const &getName() const;
     int getPos() const;
-    std::vector<Item> getItems() const;
+    std::vector<Item> const &getItems() const;
 
-    void setID(int givenId);
+    void setID(std::int64_t givenId);
     void setName(std::string givenName);
     void setPos(int givenPos);
     void addItem(Item &givenItem);
 
   private:
-    int id;
+    std::int64_t id;
     std::string name;
     int position;
     std::vector<Item> items;
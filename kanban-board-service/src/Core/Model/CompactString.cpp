@@ -0,0 +1,117 @@
+#include "CompactString.hpp"
+#include <cstring>
+
+using namespace Prog3::Core::Model;
+
+CompactString::CompactString() {
+    assign(std::string_view(), std::string_view());
+}
+
+CompactString::CompactString(std::string_view text) {
+    assign(text, std::string_view());
+}
+
+CompactString::CompactString(std::string_view text, std::string_view extra) {
+    assign(text, extra);
+}
+
+CompactString::CompactString(CompactString const &other) {
+    assign(other.view(), other.extra());
+}
+
+CompactString::CompactString(CompactString &&other) noexcept {
+    // the heap block changes hands, the moved from string is left empty
+    std::memcpy(bytes, other.bytes, sizeof(bytes));
+    other.assign(std::string_view(), std::string_view());
+}
+
+CompactString &CompactString::operator=(CompactString const &other) {
+    if (this != &other) {
+        release();
+        assign(other.view(), other.extra());
+    }
+
+    return *this;
+}
+
+CompactString &CompactString::operator=(CompactString &&other) noexcept {
+    if (this != &other) {
+        release();
+        std::memcpy(bytes, other.bytes, sizeof(bytes));
+        other.assign(std::string_view(), std::string_view());
+    }
+
+    return *this;
+}
+
+CompactString::~CompactString() {
+    release();
+}
+
+std::string_view CompactString::view() const {
+    if (isInline()) {
+        return std::string_view(bytes, INLINE_CAPACITY - static_cast<unsigned char>(bytes[15]));
+    }
+
+    return std::string_view(heapData(), size());
+}
+
+size_t CompactString::size() const {
+    if (isInline()) {
+        return INLINE_CAPACITY - static_cast<unsigned char>(bytes[15]);
+    }
+
+    std::uint32_t heapSize;
+    std::memcpy(&heapSize, bytes + 8, sizeof(heapSize));
+
+    return heapSize;
+}
+
+std::string_view CompactString::extra() const {
+    if (isInline()) {
+        return std::string_view();
+    }
+
+    return std::string_view(heapData() + size(), extraSize());
+}
+
+size_t CompactString::extraSize() const {
+    return static_cast<unsigned char>(bytes[12]) | static_cast<unsigned char>(bytes[13]) << 8 |
+           static_cast<size_t>(static_cast<unsigned char>(bytes[14])) << 16;
+}
+
+char *CompactString::heapData() const {
+    char *data;
+    std::memcpy(&data, bytes, sizeof(data));
+
+    return data;
+}
+
+void CompactString::assign(std::string_view text, std::string_view extra) {
+    if (text.size() <= INLINE_CAPACITY && extra.empty()) {
+        std::memset(bytes, 0, sizeof(bytes));
+        std::memcpy(bytes, text.data(), text.size());
+        bytes[15] = static_cast<char>(INLINE_CAPACITY - text.size());
+        return;
+    }
+
+    extra = extra.substr(0, EXTRA_CAPACITY);
+    char *data = new char[text.size() + extra.size()];
+    std::memcpy(data, text.data(), text.size());
+    std::memcpy(data + text.size(), extra.data(), extra.size());
+
+    std::uint32_t heapSize = static_cast<std::uint32_t>(text.size());
+    std::memcpy(bytes, &data, sizeof(data));
+    std::memcpy(bytes + 8, &heapSize, sizeof(heapSize));
+    bytes[12] = static_cast<char>(extra.size() & 0xff);
+    bytes[13] = static_cast<char>(extra.size() >> 8 & 0xff);
+    bytes[14] = static_cast<char>(extra.size() >> 16 & 0xff);
+    bytes[15] = static_cast<char>(HEAP_TAG);
+}
+
+void CompactString::release() {
+    if (!isInline()) {
+        delete[] heapData();
+        assign(std::string_view(), std::string_view());
+    }
+}
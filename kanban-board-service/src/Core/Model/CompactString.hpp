@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace Prog3 {
+namespace Core {
+namespace Model {
+
+// Immutable string in 16 bytes, half of a std::string. Up to 15 characters
+// are kept inline, longer ones in a heap block of exactly their size. Used
+// for item titles, of which a resident board holds one per card. A rarely
+// needed second string, the extra, can follow the text in the heap block,
+// e.g. the date text of an item whose date could not be read.
+class CompactString {
+  private:
+    static inline size_t const INLINE_CAPACITY = 15;
+    static inline size_t const EXTRA_CAPACITY = 0xffffff;
+    static inline unsigned char const HEAP_TAG = 0xff;
+
+    // inline: the characters, byte 15 holds INLINE_CAPACITY - size.
+    // heap: the pointer in bytes 0-7, the size in bytes 8-11, the size of the
+    // extra in bytes 12-14, byte 15 HEAP_TAG
+    alignas(8) char bytes[16];
+
+    bool isInline() const {
+        return static_cast<unsigned char>(bytes[15]) != HEAP_TAG;
+    }
+    char *heapData() const;
+    size_t extraSize() const;
+    void assign(std::string_view text, std::string_view extra);
+    void release();
+
+  public:
+    CompactString();
+    CompactString(std::string_view text);
+    // an extra longer than EXTRA_CAPACITY is cut
+    CompactString(std::string_view text, std::string_view extra);
+    CompactString(CompactString const &other);
+    CompactString(CompactString &&other) noexcept;
+    CompactString &operator=(CompactString const &other);
+    CompactString &operator=(CompactString &&other) noexcept;
+    ~CompactString();
+
+    std::string_view view() const;
+    size_t size() const;
+    // empty if there is none
+    std::string_view extra() const;
+
+    operator std::string_view() const {
+        return view();
+    }
+    std::string str() const {
+        return std::string(view());
+    }
+};
+
+static_assert(sizeof(CompactString) == 16, "CompactString is meant to stay at 16 bytes");
+
+} // namespace Model
+} // namespace Core
+} // namespace Prog3
@@ -3,39 +3,47 @@
 using namespace Prog3::Core::Model;
 
 Item::Item()
-    : id(-1) {}
+    : id(-1), timestamp(0), position(0) {}
 
-Item::Item(int id, std::string givenTitle, int givenPosition, std::string givenTimestamp)
-    : id(id), title(givenTitle), position(givenPosition), timestamp(givenTimestamp) {}
+Item::Item(std::int64_t id, std::string_view givenTitle, int givenPosition, std::int64_t givenTimestamp)
+    : id(id), timestamp(givenTimestamp), title(givenTitle), position(givenPosition) {}
 
-int Item::getId() const {
+std::int64_t Item::getId() const {
     return id;
 }
 
-std::string Item::getTitle() const {
-    return title;
+std::string_view Item::getTitle() const {
+    return title.view();
 }
 
 int Item::getPos() const {
     return position;
 }
 
-std::string Item::getTimestamp() const {
+std::int64_t Item::getTimestamp() const {
     return timestamp;
 }
 
-void Item::setID(int givenID) {
+std::string_view Item::getDateText() const {
+    return title.extra();
+}
+
+void Item::setID(std::int64_t givenID) {
     id = givenID;
 }
 
-void Item::setTitle(std::string givenTitle) {
-    title = givenTitle;
+void Item::setTitle(std::string_view givenTitle) {
+    title = CompactString(givenTitle, title.extra());
 }
 
 void Item::setPos(int givenPos) {
     position = givenPos;
 }
 
-void Item::setTimestamp(std::string givenTime) {
-    timestamp = givenTime;
+void Item::setTimestamp(std::int64_t givenTimestamp) {
+    timestamp = givenTimestamp;
+}
+
+void Item::setDateText(std::string_view givenDateText) {
+    title = CompactString(title.view(), givenDateText);
 }
@@ -1,6 +1,8 @@
 #pragma once
 
-#include <string>
+#include "CompactString.hpp"
+#include <cstdint>
+#include <string_view>
 
 namespace Prog3 {
 namespace Core {
@@ -9,24 +11,29 @@ namespace Model {
 class Item {
   public:
     Item();
-    Item(int id, std::string givenTitle, int givenPosition, std::string givenTimestamp);
+    Item(std::int64_t id, std::string_view givenTitle, int givenPosition, std::int64_t givenTimestamp);
     ~Item(){};
 
-    int getId() const;
-    std::string getTitle() const;
+    std::int64_t getId() const;
+    std::string_view getTitle() const;
     int getPos() const;
-    std::string getTimestamp() const;
+    // unix time in seconds, see formatTimestamp
+    std::int64_t getTimestamp() const;
+    // the text of the date column of a row whose date could not be read, empty otherwise
+    std::string_view getDateText() const;
 
-    void setID(int givenID);
-    void setTitle(std::string givenTitle);
+    void setID(std::int64_t givenID);
+    void setTitle(std::string_view givenTitle);
     void setPos(int givenPos);
-    void setTimestamp(std::string givenTime);
+    void setTimestamp(std::int64_t givenTimestamp);
+    void setDateText(std::string_view givenDateText);
 
   private:
-    int id;
-    std::string title;
+    std::int64_t id;
+    std::int64_t timestamp;
+    // the date text, if any, is the extra of the title, items without one pay nothing for it
+    CompactString title;
     int position;
-    std::string timestamp;
 };
 
 } // namespace Model
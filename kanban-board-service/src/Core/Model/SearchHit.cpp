@@ -0,0 +1,14 @@
+#include "SearchHit.hpp"
+
+using namespace Prog3::Core::Model;
+
+SearchHit::SearchHit(std::int64_t givenColumnId, Item const &givenItem)
+    : columnId(givenColumnId), item(givenItem) {}
+
+std::int64_t SearchHit::getColumnId() const {
+    return columnId;
+}
+
+Item const &SearchHit::getItem() const {
+    return item;
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "Item.hpp"
+#include <cstdint>
+
+namespace Prog3 {
+namespace Core {
+namespace Model {
+
+class SearchHit {
+  public:
+    SearchHit(std::int64_t givenColumnId, Item const &givenItem);
+    ~SearchHit() {}
+
+    std::int64_t getColumnId() const;
+    Item const &getItem() const;
+
+  private:
+    std::int64_t columnId;
+    Item item;
+};
+
+} // namespace Model
+} // namespace Core
+} // namespace Prog3
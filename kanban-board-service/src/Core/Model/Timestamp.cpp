@@ -0,0 +1,200 @@
+#include "Timestamp.hpp"
+#include <cctype>
+#include <cstring>
+#include <ctime>
+
+#ifdef _WIN32
+#include <iomanip>
+#include <locale>
+#include <sstream>
+#endif
+
+namespace Prog3 {
+namespace Core {
+namespace Model {
+
+namespace {
+
+std::int64_t const SECONDS_PER_DAY = 86400;
+
+char const *const WEEKDAYS[] = {"Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat"};
+char const *const MONTHS[] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+
+std::int64_t floorDivide(std::int64_t value, std::int64_t divisor) {
+    return value / divisor - ((value % divisor < 0) ? 1 : 0);
+}
+
+bool toLocalTime(std::time_t time, std::tm &local) {
+#ifdef _WIN32
+    return localtime_s(&local, &time) == 0;
+#else
+    return localtime_r(&time, &local) != nullptr;
+#endif
+}
+
+// seconds east of utc, local is time converted by toLocalTime
+long getLocalOffset([[maybe_unused]] std::time_t time, std::tm const &local) {
+#ifdef _WIN32
+    std::tm copy = local;
+    return static_cast<long>(_mkgmtime(&copy) - time);
+#else
+    return local.tm_gmtoff;
+#endif
+}
+
+// the number of characters of text that make up the date, std::string::npos if it is none
+std::size_t readLocalTime(std::string const &text, char const *format, std::tm &local) {
+#ifdef _WIN32
+    std::istringstream stream(text);
+    stream.imbue(std::locale::classic());
+    stream >> std::get_time(&local, format);
+    if (stream.fail()) {
+        return std::string::npos;
+    }
+
+    return stream.eof() ? text.size() : static_cast<std::size_t>(stream.tellg());
+#else
+    char const *end = strptime(text.c_str(), format, &local);
+
+    return end == nullptr ? std::string::npos : static_cast<std::size_t>(end - text.c_str());
+#endif
+}
+
+// localtime_r takes the time zone lock and costs more than the rest of an item's
+// serialization. The utc offset of the last day seen is kept per thread instead,
+// days with a daylight saving switch are converted one timestamp at a time
+struct UtcOffsetCache {
+    std::int64_t day = INT64_MIN;
+    bool constant = false;
+    long offset = 0;
+};
+
+bool getUtcOffset(std::int64_t timestamp, long &offset) {
+    thread_local UtcOffsetCache cache;
+    std::int64_t day = floorDivide(timestamp, SECONDS_PER_DAY);
+
+    if (day != cache.day) {
+        std::time_t first = static_cast<std::time_t>(day * SECONDS_PER_DAY);
+        std::time_t last = first + SECONDS_PER_DAY - 1;
+        std::tm firstLocal, lastLocal;
+
+        cache.day = day;
+        cache.constant = toLocalTime(first, firstLocal) && toLocalTime(last, lastLocal) &&
+                         getLocalOffset(first, firstLocal) == getLocalOffset(last, lastLocal);
+        cache.offset = cache.constant ? getLocalOffset(first, firstLocal) : 0;
+    }
+
+    if (cache.constant) {
+        offset = cache.offset;
+        return true;
+    }
+
+    std::time_t time = static_cast<std::time_t>(timestamp);
+    std::tm local;
+    if (!toLocalTime(time, local)) {
+        return false;
+    }
+
+    offset = getLocalOffset(time, local);
+    return true;
+}
+
+void writeDigits(char *text, int value, int count, char padding) {
+    for (int i = count - 1; i >= 0; i--) {
+        text[i] = (value > 0 || i == count - 1) ? static_cast<char>('0' + value % 10) : padding;
+        value /= 10;
+    }
+}
+
+} // namespace
+
+std::string formatTimestamp(std::int64_t timestamp) {
+    char text[32];
+    std::size_t length = formatTimestamp(timestamp, text, sizeof(text));
+
+    return std::string(text, length);
+}
+
+std::size_t formatTimestamp(std::int64_t timestamp, char *text, std::size_t capacity) {
+    std::size_t const length = 24; // "Mon Jan  1 00:00:00 2024"
+    long offset;
+
+    if (capacity <= length || !getUtcOffset(timestamp, offset)) {
+        return 0;
+    }
+
+    std::int64_t localTime = timestamp + offset;
+    std::int64_t days = floorDivide(localTime, SECONDS_PER_DAY);
+    std::int64_t secondOfDay = localTime - days * SECONDS_PER_DAY;
+
+    // civil date from days since 1970-01-01, see howardhinnant.github.io/date_algorithms.html
+    std::int64_t shifted = days + 719468;
+    std::int64_t era = floorDivide(shifted, 146097);
+    std::int64_t dayOfEra = shifted - era * 146097;
+    std::int64_t yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    std::int64_t dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    std::int64_t monthIndex = (5 * dayOfYear + 2) / 153;
+    int day = static_cast<int>(dayOfYear - (153 * monthIndex + 2) / 5 + 1);
+    int month = static_cast<int>(monthIndex < 10 ? monthIndex + 3 : monthIndex - 9);
+    std::int64_t year = yearOfEra + era * 400 + (month <= 2 ? 1 : 0);
+
+    if (year < 1000 || year > 9999) {
+        return 0;
+    }
+
+    char const *weekday = WEEKDAYS[((days + 4) % 7 + 7) % 7]; // 1970-01-01 was a thursday
+    char const *monthName = MONTHS[month - 1];
+
+    text[0] = weekday[0], text[1] = weekday[1], text[2] = weekday[2], text[3] = ' ';
+    text[4] = monthName[0], text[5] = monthName[1], text[6] = monthName[2], text[7] = ' ';
+    writeDigits(text + 8, day, 2, ' ');
+    text[10] = ' ';
+    writeDigits(text + 11, static_cast<int>(secondOfDay / 3600), 2, '0');
+    text[13] = ':';
+    writeDigits(text + 14, static_cast<int>(secondOfDay / 60 % 60), 2, '0');
+    text[16] = ':';
+    writeDigits(text + 17, static_cast<int>(secondOfDay % 60), 2, '0');
+    text[19] = ' ';
+    writeDigits(text + 20, static_cast<int>(year), 4, '0');
+    text[length] = '\0';
+
+    return length;
+}
+
+bool parseTimestamp(std::string_view text, std::int64_t &timestamp) {
+    std::string terminated(text);
+
+    for (char const *format : {"%a %b %e %H:%M:%S %Y", "%Y-%m-%d %H:%M:%S", "%Y-%m-%d"}) {
+        std::tm local = {};
+        std::size_t length = readLocalTime(terminated, format, local);
+        if (length == std::string::npos) {
+            continue;
+        }
+
+        // fractions of a second are dropped, anything else after the date makes it no date
+        if (format[std::strlen(format) - 1] == 'S' && length < terminated.size() && terminated[length] == '.') {
+            length++;
+            while (length < terminated.size() && std::isdigit(static_cast<unsigned char>(terminated[length]))) {
+                length++;
+            }
+        }
+        if (length != terminated.size()) {
+            continue;
+        }
+
+        local.tm_isdst = -1;
+        std::time_t time = std::mktime(&local);
+        if (time == static_cast<std::time_t>(-1)) {
+            return false;
+        }
+
+        timestamp = static_cast<std::int64_t>(time);
+        return true;
+    }
+
+    return false;
+}
+
+} // namespace Model
+} // namespace Core
+} // namespace Prog3
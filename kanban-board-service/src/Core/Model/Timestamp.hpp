@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace Prog3 {
+namespace Core {
+namespace Model {
+
+// Items keep their timestamp as unix time in seconds. The api and the date
+// column show it like ctime() in local time, e.g. "Mon Jan  1 00:00:00 2024".
+std::string formatTimestamp(std::int64_t timestamp);
+// same into text without allocating, returns the length, 0 if it does not fit
+std::size_t formatTimestamp(std::int64_t timestamp, char *text, std::size_t capacity);
+
+// reads the ctime() form back, as well as "2024-01-01 00:00:00" (also with
+// fractions) and "2024-01-01" for rows written by other tools. false if text is
+// none of them or has anything after the date. Items are read from the created
+// column, only the schema migration that brought it in reads the date text. In
+// the hour repeated when daylight saving ends mktime picks one of the two
+bool parseTimestamp(std::string_view text, std::int64_t &timestamp);
+
+} // namespace Model
+} // namespace Core
+} // namespace Prog3
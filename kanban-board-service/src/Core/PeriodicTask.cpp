@@ -0,0 +1,57 @@
+#include "PeriodicTask.hpp"
+#include "crow/logging.h"
+
+using namespace Prog3::Core;
+
+PeriodicTask::PeriodicTask(std::string givenName, std::chrono::milliseconds givenInterval, std::function<void()> givenTask)
+    : name(givenName), interval(givenInterval), task(givenTask), stopping(false) {
+
+    // wait_for returns at once for an interval of 0 or less, the worker would spin
+    if (interval < MIN_INTERVAL) {
+        CROW_LOG_WARNING << "Periodic task " << name << " interval " << interval.count() << " ms is too short, using "
+                         << MIN_INTERVAL.count() << " ms";
+        interval = MIN_INTERVAL;
+    }
+
+    worker = std::thread(&PeriodicTask::run, this);
+}
+
+PeriodicTask::~PeriodicTask() {
+    stop();
+}
+
+void PeriodicTask::stop() {
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        stopping = true;
+    }
+    wakeup.notify_all();
+
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+void PeriodicTask::runNow() {
+    std::lock_guard<std::mutex> lock(runMutex);
+
+    try {
+        task();
+    } catch (std::exception const &exception) {
+        CROW_LOG_ERROR << "Periodic task " << name << " failed: " << exception.what();
+    }
+}
+
+void PeriodicTask::run() {
+    std::unique_lock<std::mutex> lock(stateMutex);
+
+    while (!stopping) {
+        if (wakeup.wait_for(lock, interval, [this] { return stopping; })) {
+            break;
+        }
+
+        lock.unlock();
+        runNow();
+        lock.lock();
+    }
+}
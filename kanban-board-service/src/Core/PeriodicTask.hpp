@@ -0,0 +1,41 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace Prog3 {
+namespace Core {
+
+// Runs a maintenance task on its own thread every interval until it is
+// stopped or destroyed. The first run happens one interval after start.
+class PeriodicTask {
+  public:
+    PeriodicTask(std::string givenName, std::chrono::milliseconds givenInterval, std::function<void()> givenTask);
+    ~PeriodicTask();
+
+    // runs the task on the caller's thread, serialized with the scheduled runs
+    void runNow();
+    void stop();
+
+  private:
+    static constexpr std::chrono::milliseconds MIN_INTERVAL{1};
+
+    std::string name;
+    std::chrono::milliseconds interval;
+    std::function<void()> task;
+
+    std::mutex runMutex;
+    std::mutex stateMutex;
+    std::condition_variable wakeup;
+    bool stopping;
+    std::thread worker;
+
+    void run();
+};
+
+} // namespace Core
+} // namespace Prog3
@@ -0,0 +1,33 @@
+#include "RequestContext.hpp"
+#include "Core/Exception/DeadlineExceededException.hpp"
+
+using namespace Prog3::Core;
+
+thread_local RequestContext RequestContext::currentContext;
+
+RequestContext::Scope::Scope(std::optional<Clock::time_point> deadline, RequestPriority priority, std::pmr::memory_resource *memoryResource)
+    : previousDeadline(currentContext.deadline), previousPriority(currentContext.priority), previousMemoryResource(currentContext.memoryResource) {
+    currentContext.deadline = deadline;
+    currentContext.priority = priority;
+    currentContext.memoryResource = memoryResource;
+}
+
+RequestContext::Scope::~Scope() {
+    currentContext.deadline = previousDeadline;
+    currentContext.priority = previousPriority;
+    currentContext.memoryResource = previousMemoryResource;
+}
+
+RequestContext const &RequestContext::current() {
+    return currentContext;
+}
+
+bool RequestContext::isExpired() const {
+    return deadline && Clock::now() >= *deadline;
+}
+
+void RequestContext::checkDeadline() {
+    if (currentContext.isExpired()) {
+        throw Prog3::Core::Exception::DeadlineExceededException();
+    }
+}
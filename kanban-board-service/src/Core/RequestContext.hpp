@@ -0,0 +1,78 @@
+#pragma once
+
+#include <chrono>
+#include <memory_resource>
+#include <optional>
+
+namespace Prog3 {
+namespace Core {
+
+// order in which requests get the board's database handle, see StorageScheduler
+enum class RequestPriority {
+    Interactive,
+    Write,
+    Bulk
+};
+
+struct DeadlineOptions {
+    // used when the client sends no X-Request-Timeout-Ms header
+    std::chrono::milliseconds readTimeout{5000};
+    std::chrono::milliseconds writeTimeout{10000};
+    // the longest a client may ask for, so now() plus the header cannot overflow
+    std::chrono::milliseconds maxTimeout{60000};
+};
+
+// What the layers below Endpoint need to know about the request running on
+// this thread. Crow runs a handler start to finish on one thread, so the
+// context travels with the call chain without being passed through
+// BoardManager and RepositoryIf. Threads without a scope (background tasks)
+// have no deadline, bulk priority and allocate from the default resource.
+class RequestContext {
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    // installs a context for the current thread and restores the previous one
+    class Scope {
+      private:
+        std::optional<Clock::time_point> previousDeadline;
+        RequestPriority previousPriority;
+        std::pmr::memory_resource *previousMemoryResource;
+
+      public:
+        // memoryResource has to outlive the scope
+        Scope(std::optional<Clock::time_point> deadline, RequestPriority priority,
+              std::pmr::memory_resource *memoryResource = std::pmr::get_default_resource());
+        ~Scope();
+
+        Scope(Scope const &) = delete;
+        Scope &operator=(Scope const &) = delete;
+    };
+
+    static RequestContext const &current();
+
+    std::optional<Clock::time_point> getDeadline() const {
+        return deadline;
+    }
+    RequestPriority getPriority() const {
+        return priority;
+    }
+    // scratch memory of the request, everything allocated from it is released
+    // at once when the request is done. nothing kept beyond the request may use it
+    std::pmr::memory_resource *getMemoryResource() const {
+        return memoryResource;
+    }
+    bool isExpired() const;
+
+    // throws DeadlineExceededException once the current request's deadline has passed
+    static void checkDeadline();
+
+  private:
+    std::optional<Clock::time_point> deadline;
+    RequestPriority priority = RequestPriority::Bulk;
+    std::pmr::memory_resource *memoryResource = std::pmr::get_default_resource();
+
+    static thread_local RequestContext currentContext;
+};
+
+} // namespace Core
+} // namespace Prog3
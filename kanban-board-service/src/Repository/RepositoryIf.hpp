@@ -1,6 +1,9 @@
 #pragma once
 
+#include "Core/Model/ArchivedItem.hpp"
 #include "Core/Model/Board.hpp"
+#include "Core/Model/ChangeSet.hpp"
+#include "Core/Model/SearchHit.hpp"
 #include "optional"
 
 namespace Prog3 {
@@ -11,15 +14,24 @@ class RepositoryIf {
 
     virtual Prog3::Core::Model::Board getBoard() = 0;
     virtual std::vector<Prog3::Core::Model::Column> getColumns() = 0;
-    virtual std::optional<Prog3::Core::Model::Column> getColumn(int id) = 0;
+    virtual std::optional<Prog3::Core::Model::Column> getColumn(std::int64_t id) = 0;
     virtual std::optional<Prog3::Core::Model::Column> postColumn(std::string name, int position) = 0;
-    virtual std::optional<Prog3::Core::Model::Column> putColumn(int id, std::string name, int position) = 0;
-    virtual void deleteColumn(int id) = 0;
-    virtual std::vector<Prog3::Core::Model::Item> getItems(int columnId) = 0;
-    virtual std::optional<Prog3::Core::Model::Item> getItem(int columnId, int itemId) = 0;
-    virtual std::optional<Prog3::Core::Model::Item> postItem(int columnId, std::string title, int position) = 0;
-    virtual std::optional<Prog3::Core::Model::Item> putItem(int columnId, int itemId, std::string title, int position) = 0;
-    virtual void deleteItem(int columnId, int itemId) = 0;
+    virtual std::optional<Prog3::Core::Model::Column> putColumn(std::int64_t id, std::string name, int position) = 0;
+    virtual void deleteColumn(std::int64_t id) = 0;
+    virtual std::vector<Prog3::Core::Model::Item> getItems(std::int64_t columnId) = 0;
+    virtual std::optional<Prog3::Core::Model::Item> getItem(std::int64_t columnId, std::int64_t itemId) = 0;
+    virtual std::optional<Prog3::Core::Model::Item> postItem(std::int64_t columnId, std::string title, int position) = 0;
+    virtual std::optional<Prog3::Core::Model::Item> putItem(std::int64_t columnId, std::int64_t itemId, std::string title, int position) = 0;
+    virtual void deleteItem(std::int64_t columnId, std::int64_t itemId) = 0;
+
+    virtual std::int64_t getVersion() = 0;
+    // the same as getVersion without waiting for the board's handle, commits made
+    // outside the service included. for the task that picks those up, not for every read
+    virtual std::int64_t peekVersion() = 0;
+    virtual std::optional<Prog3::Core::Model::ChangeSet> getChangesSince(std::int64_t version) = 0;
+
+    virtual std::vector<Prog3::Core::Model::SearchHit> searchItems(std::string query, int limit, int offset) = 0;
+    virtual std::vector<Prog3::Core::Model::ArchivedItem> getArchivedItems(int limit, int offset) = 0;
 };
 
 } // namespace Repository
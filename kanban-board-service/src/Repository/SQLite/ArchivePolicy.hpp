@@ -0,0 +1,20 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace Prog3 {
+namespace Repository {
+namespace SQLite {
+
+// Items in one of the named columns that were not modified for maxAge are
+// moved from item to item_archive. No column names means archiving is off.
+struct ArchivePolicy {
+    std::vector<std::string> columnNames;
+    std::chrono::seconds maxAge{std::chrono::hours(24 * 30)};
+};
+
+} // namespace SQLite
+} // namespace Repository
+} // namespace Prog3
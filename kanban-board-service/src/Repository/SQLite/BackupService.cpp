@@ -0,0 +1,123 @@
+#include "BackupService.hpp"
+#include "crow/logging.h"
+#include <algorithm>
+#include <ctime>
+#include <filesystem>
+#include <vector>
+
+using namespace Prog3::Repository::SQLite;
+using namespace Prog3::Core::Metrics;
+using namespace std;
+
+BackupService::BackupService(BoardRepositoryPool &givenRepositoryPool, MetricsRegistry &givenMetrics, BackupOptions givenOptions)
+    : repositoryPool(givenRepositoryPool), metrics(givenMetrics), options(givenOptions), running(false) {
+
+    if (options.directory.empty()) {
+        options.directory = getDefaultDirectory();
+    }
+}
+
+BackupService::~BackupService() {
+    if (backgroundRun.joinable()) {
+        backgroundRun.join();
+    }
+}
+
+std::string BackupService::getDefaultDirectory() const {
+    std::string databaseFile = repositoryPool.getDatabaseFile(BoardRepositoryPool::DEFAULT_BOARD_ID);
+    return (filesystem::path(databaseFile).parent_path() / "backups").string();
+}
+
+bool BackupService::run() {
+    if (running.exchange(true)) {
+        return false;
+    }
+
+    backupAll();
+    running = false;
+
+    return true;
+}
+
+bool BackupService::start() {
+    if (running.exchange(true)) {
+        return false;
+    }
+
+    // the previous background run has finished, running was false
+    if (backgroundRun.joinable()) {
+        backgroundRun.join();
+    }
+
+    backgroundRun = std::thread([this]() {
+        backupAll();
+        running = false;
+    });
+
+    return true;
+}
+
+void BackupService::backupAll() {
+    std::error_code errorCode;
+    filesystem::create_directories(options.directory, errorCode);
+
+    repositoryPool.forEachRepository([this](int boardId, BoardRepository &repository) {
+        backupBoard(boardId, repository);
+    });
+}
+
+bool BackupService::backupBoard(int boardId, BoardRepository &repository) {
+    string board = to_string(boardId);
+    string prefix = "kanban-board-" + board + "-";
+
+    // utc timestamps sort in creation order, which removeOldBackups relies on
+    char timestamp[32];
+    time_t now = time(0);
+    strftime(timestamp, sizeof(timestamp), "%Y%m%dT%H%M%SZ", gmtime(&now));
+
+    string targetFile = (filesystem::path(options.directory) / (prefix + timestamp + ".db")).string();
+
+    auto started = chrono::steady_clock::now();
+    metrics.setGauge(MetricsRegistry::withLabel("kanban_backup_running", "board", board), 1);
+
+    bool succeeded = repository.backup(targetFile, options.pagesPerStep, options.stepPause, [this, &board](int remaining, int total) {
+        double progress = (total > 0) ? static_cast<double>(total - remaining) / total : 1.0;
+        metrics.setGauge(MetricsRegistry::withLabel("kanban_backup_progress", "board", board), progress);
+        metrics.setGauge(MetricsRegistry::withLabel("kanban_backup_pages_remaining", "board", board), remaining);
+    });
+
+    chrono::duration<double> duration = chrono::steady_clock::now() - started;
+    metrics.setGauge(MetricsRegistry::withLabel("kanban_backup_running", "board", board), 0);
+    metrics.observe(MetricsRegistry::withLabel("kanban_backup_duration_seconds", "board", board), duration.count());
+
+    if (succeeded) {
+        metrics.setGauge(MetricsRegistry::withLabel("kanban_backup_last_success_timestamp_seconds", "board", board), now);
+        removeOldBackups(prefix);
+        CROW_LOG_INFO << "Backed up board " << board << " to " << targetFile << " in " << duration.count() << "s";
+    } else {
+        metrics.incrementCounter(MetricsRegistry::withLabel("kanban_backup_failures_total", "board", board));
+    }
+
+    return succeeded;
+}
+
+void BackupService::removeOldBackups(std::string const &prefix) {
+    std::vector<filesystem::path> backups;
+    std::error_code errorCode;
+
+    for (auto const &entry : filesystem::directory_iterator(options.directory, errorCode)) {
+        string fileName = entry.path().filename().string();
+
+        if (fileName.rfind(prefix, 0) == 0 && entry.path().extension() == ".db") {
+            backups.push_back(entry.path());
+        }
+    }
+
+    if (static_cast<int>(backups.size()) <= options.keep) {
+        return;
+    }
+
+    std::sort(backups.begin(), backups.end());
+    for (size_t i = 0; i + options.keep < backups.size(); i++)
+        filesystem::remove(backups[i], errorCode);
+}
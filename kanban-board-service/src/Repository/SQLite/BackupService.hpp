@@ -0,0 +1,51 @@
+#pragma once
+
+#include "BoardRepositoryPool.hpp"
+#include "Core/Metrics/MetricsRegistry.hpp"
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+
+namespace Prog3 {
+namespace Repository {
+namespace SQLite {
+
+struct BackupOptions {
+    // empty: "backups" next to the default board's file
+    std::string directory;
+    int pagesPerStep = 64;
+    std::chrono::milliseconds stepPause{10};
+    // backups kept per board, older ones are deleted after a successful run
+    int keep = 3;
+};
+
+// Backs up every open board while the service keeps running, either on the
+// caller's thread (scheduled runs) or in the background (admin trigger).
+class BackupService {
+  private:
+    BoardRepositoryPool &repositoryPool;
+    Prog3::Core::Metrics::MetricsRegistry &metrics;
+    BackupOptions options;
+
+    std::atomic<bool> running;
+    std::thread backgroundRun;
+
+    void backupAll();
+    bool backupBoard(int boardId, BoardRepository &repository);
+    void removeOldBackups(std::string const &prefix);
+
+  public:
+    BackupService(BoardRepositoryPool &givenRepositoryPool, Prog3::Core::Metrics::MetricsRegistry &givenMetrics, BackupOptions givenOptions);
+    ~BackupService();
+
+    // both return false if a backup is already in progress
+    bool run();
+    bool start();
+
+    std::string getDefaultDirectory() const;
+};
+
+} // namespace SQLite
+} // namespace Repository
+} // namespace Prog3
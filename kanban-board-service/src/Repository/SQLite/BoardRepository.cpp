@@ -1,14 +1,22 @@
 #include "BoardRepository.hpp"
+#include "SchemaMigrator.hpp"
+#include "Core/Exception/DeadlineExceededException.hpp"
 #include "Core/Exception/NotImplementedException.hpp"
+#include "Core/Model/Timestamp.hpp"
+#include "Core/RequestContext.hpp"
 #include "crow/logging.h"
 #include "rapidjson/document.h"
 #include "rapidjson/rapidjson.h"
 #include <filesystem>
+#include <sstream>
+#include <thread>
 #include <string.h>
 
 using namespace Prog3::Repository::SQLite;
+using namespace Prog3::Core;
 using namespace Prog3::Core::Model;
 using namespace Prog3::Core::Exception;
+using namespace Prog3::Core::Metrics;
 using namespace rapidjson;
 using namespace std;
 
@@ -18,65 +26,63 @@ string const BoardRepository::databaseFile = "./data/kanban-board.db";
 string const BoardRepository::databaseFile = "../data/kanban-board.db";
 #endif
 
-BoardRepository::BoardRepository() : database(nullptr) {
+BoardRepository::BoardRepository() : BoardRepository(databaseFile, boardTitle) {
+}
+
+BoardRepository::BoardRepository(std::string givenDatabaseFile, std::string givenTitle)
+    : database(nullptr), databasePath(givenDatabaseFile), shardTitle(givenTitle), versionDatabase(nullptr), selectDataVersion(nullptr),
+      selectVersion(nullptr), dataVersion(-1), knownVersion(0) {
 
-    string databaseDirectory = filesystem::path(databaseFile).parent_path().string();
+    string databaseDirectory = filesystem::path(givenDatabaseFile).parent_path().string();
 
     if (filesystem::is_directory(databaseDirectory) == false) {
-        filesystem::create_directory(databaseDirectory);
+        filesystem::create_directories(databaseDirectory);
     }
 
-    int result = sqlite3_open(databaseFile.c_str(), &database);
+    int result = sqlite3_open(givenDatabaseFile.c_str(), &database);
 
     if (SQLITE_OK != result) {
         cout << "Cannot open database: " << sqlite3_errmsg(database) << endl;
     }
 
     initialize();
+    openVersionConnection();
 }
 
 BoardRepository::~BoardRepository() {
+    sqlite3_finalize(selectDataVersion);
+    sqlite3_finalize(selectVersion);
+    sqlite3_close(versionDatabase);
     sqlite3_close(database);
 }
 
 void BoardRepository::initialize() {
-    int result = 0;
-    char *errorMessage = nullptr;
+    SchemaMigrator migrator(database);
+    migrator.migrate();
 
-    string sqlCreateTableColumn =
-        "create table if not exists column("
-        "id integer not null primary key autoincrement,"
-        "name text not null,"
-        "position integer not null UNIQUE);";
-
-    string sqlCreateTableItem =
-        "create table if not exists item("
-        "id integer not null primary key autoincrement,"
-        "title text not null,"
-        "date text not null,"
-        "position integer not null,"
-        "column_id integer not null,"
-        "unique (position, column_id),"
-        "foreign key (column_id) references column (id));";
-
-    result = sqlite3_exec(database, sqlCreateTableColumn.c_str(), NULL, 0, &errorMessage);
+    // readers no longer wait for writers in wal mode. checkpoints are left to
+    // the CheckpointScheduler, otherwise sqlite runs them inside whichever
+    // commit happens to push the wal past 1000 pages
+    char *errorMessage = nullptr;
+    int result = sqlite3_exec(database, "pragma journal_mode = wal; pragma wal_autocheckpoint = 0;", NULL, 0, &errorMessage);
     handleSQLError(result, errorMessage);
 
-    result = sqlite3_exec(database, sqlCreateTableItem.c_str(), NULL, 0, &errorMessage);
-    handleSQLError(result, errorMessage);
+    // statements of a request whose deadline has passed are interrupted
+    sqlite3_progress_handler(database, PROGRESS_HANDLER_INSTRUCTIONS, progressCallback, nullptr);
 
     // only if dummy data is needed ;)
     // createDummyData();
 }
 
 Board BoardRepository::getBoard() {
-    Board board(boardTitle);
+    Board board(shardTitle);
     board.setColumns(getColumns());
 
     return board;
 }
 
 std::vector<Column> BoardRepository::getColumns() {
+    StorageScheduler::Turn turn(scheduler);
     int result = 0;
     char *errorMessage = nullptr;
 
@@ -99,7 +105,8 @@ std::vector<Column> BoardRepository::getColumns() {
     return {};
 }
 
-std::optional<Column> BoardRepository::getColumn(int id) {
+std::optional<Column> BoardRepository::getColumn(std::int64_t id) {
+    StorageScheduler::Turn turn(scheduler);
     int result = 0;
     char *errorMessage = nullptr;
 
@@ -124,6 +131,9 @@ std::optional<Column> BoardRepository::getColumn(int id) {
 }
 
 std::optional<Column> BoardRepository::postColumn(std::string name, int position) {
+    StorageScheduler::Turn turn(scheduler);
+    std::lock_guard<std::mutex> writeLock(writeMutex);
+    RequestContext::checkDeadline();
     int result = 0;
     char *errorMessage = nullptr;
 
@@ -144,7 +154,10 @@ std::optional<Column> BoardRepository::postColumn(std::string name, int position
     return {};
 }
 
-std::optional<Prog3::Core::Model::Column> BoardRepository::putColumn(int id, std::string name, int position) {
+std::optional<Prog3::Core::Model::Column> BoardRepository::putColumn(std::int64_t id, std::string name, int position) {
+    StorageScheduler::Turn turn(scheduler);
+    std::lock_guard<std::mutex> writeLock(writeMutex);
+    RequestContext::checkDeadline();
     int result = 0;
     char *errorMessage = nullptr;
 
@@ -169,7 +182,10 @@ std::optional<Prog3::Core::Model::Column> BoardRepository::putColumn(int id, std
     return {};
 }
 
-void BoardRepository::deleteColumn(int id) {
+void BoardRepository::deleteColumn(std::int64_t id) {
+    StorageScheduler::Turn turn(scheduler);
+    std::lock_guard<std::mutex> writeLock(writeMutex);
+    RequestContext::checkDeadline();
     int result = 0;
     char *errorMessage = nullptr;
 
@@ -183,55 +199,46 @@ void BoardRepository::deleteColumn(int id) {
     handleSQLError(result, errorMessage);
 }
 
-std::vector<Item> BoardRepository::getItems(int columnId) {
-    int result = 0;
-    char *errorMessage = nullptr;
+std::vector<Item> BoardRepository::getItems(std::int64_t columnId) {
+    StorageScheduler::Turn turn(scheduler);
 
-    string sqlSelectItems = "select id, title, position, date from item "
+    string sqlSelectItems = "select id, title, position, created, date from item "
                             "where column_id = " +
                             std::to_string(columnId) + " order by position";
     std::vector<Item> items;
 
-    result = sqlite3_exec(database, sqlSelectItems.c_str(), allItemsCallback, &items, &errorMessage);
-    handleSQLError(result, errorMessage);
+    selectRows(sqlSelectItems, [&items](sqlite3_stmt *statement) { items.push_back(readItem(statement, 0)); });
 
-    if (!items.empty())
-        return items;
-
-    return {};
+    return items;
 }
 
-std::optional<Item> BoardRepository::getItem(int columnId, int itemId) {
-    int result = 0;
-    char *errorMessage = nullptr;
+std::optional<Item> BoardRepository::getItem(std::int64_t columnId, std::int64_t itemId) {
+    StorageScheduler::Turn turn(scheduler);
 
-    string sqlSelectItem = "select id, title, position, date from item "
+    string sqlSelectItem = "select id, title, position, created, date from item "
                            "where column_id = " +
                            std::to_string(columnId) + " and id = " + std::to_string(itemId);
-    Item item;
+    std::optional<Item> item;
 
-    result = sqlite3_exec(database, sqlSelectItem.c_str(), itemCallback, &item, &errorMessage);
-    handleSQLError(result, errorMessage);
+    selectRows(sqlSelectItem, [&item](sqlite3_stmt *statement) { item = readItem(statement, 0); });
 
-    if (result == SQLITE_OK && item.getId() != -1)
-        return item;
-
-    return {};
+    return item;
 }
 
-std::optional<Item> BoardRepository::postItem(int columnId, std::string title, int position) {
+std::optional<Item> BoardRepository::postItem(std::int64_t columnId, std::string title, int position) {
+    StorageScheduler::Turn turn(scheduler);
+    std::lock_guard<std::mutex> writeLock(writeMutex);
+    RequestContext::checkDeadline();
     int result = 0;
     char *errorMessage = nullptr;
 
     time_t ttime = time(0);
-    char *timestamp = ctime(&ttime);
-    timestamp[strlen(timestamp) - 1] = '\0'; // "remove" newline char
 
     string sqlInsertItem =
-        "insert into item (title, date, position, column_id)"
+        "insert into item (title, date, created, position, column_id, modified)"
         "values ('" +
-        title + "', '" + std::string(timestamp) +
-        "', " + std::to_string(position) + ", " + std::to_string(columnId) + ");";
+        title + "', '" + formatTimestamp(ttime) + "', " + std::to_string(ttime) +
+        ", " + std::to_string(position) + ", " + std::to_string(columnId) + ", " + std::to_string(ttime) + ");";
 
     result = sqlite3_exec(database, sqlInsertItem.c_str(), NULL, 0, &errorMessage);
     handleSQLError(result, errorMessage);
@@ -239,39 +246,46 @@ std::optional<Item> BoardRepository::postItem(int columnId, std::string title, i
     if (result == SQLITE_OK) {
         auto const columnId = sqlite3_last_insert_rowid(database);
 
-        return Item(columnId, title, position, timestamp);
+        return Item(columnId, title, position, ttime);
     }
 
     return {};
 }
 
-std::optional<Prog3::Core::Model::Item> BoardRepository::putItem(int columnId, int itemId, std::string title, int position) {
+std::optional<Prog3::Core::Model::Item> BoardRepository::putItem(std::int64_t columnId, std::int64_t itemId, std::string title, int position) {
+    StorageScheduler::Turn turn(scheduler);
+    std::lock_guard<std::mutex> writeLock(writeMutex);
+    RequestContext::checkDeadline();
     int result = 0;
     char *errorMessage = nullptr;
 
     string sqlPutItem = "update item "
                         "set title = '" +
                         title + "', position = '" + std::to_string(position) +
-                        "' where id = " + std::to_string(itemId) + " and column_id = " + std::to_string(columnId);
+                        "', modified = " + std::to_string(time(0)) +
+                        " where id = " + std::to_string(itemId) + " and column_id = " + std::to_string(columnId);
 
     result = sqlite3_exec(database, sqlPutItem.c_str(), NULL, 0, &errorMessage);
     handleSQLError(result, errorMessage);
 
-    string sqlSelectItem = "select id, title, position, date from item "
+    if (result != SQLITE_OK || sqlite3_changes(database) != 1) {
+        return {};
+    }
+
+    string sqlSelectItem = "select id, title, position, created, date from item "
                            "where column_id = " +
                            std::to_string(columnId) + " and id = " + std::to_string(itemId);
-    Item item;
-
-    result = sqlite3_exec(database, sqlSelectItem.c_str(), itemCallback, &item, &errorMessage);
-    handleSQLError(result, errorMessage);
+    std::optional<Item> item;
 
-    if (result == SQLITE_OK && sqlite3_changes(database) == 1 && item.getId() != -1)
-        return Item(itemId, title, position, item.getTimestamp());
+    selectRows(sqlSelectItem, [&item](sqlite3_stmt *statement) { item = readItem(statement, 0); });
 
-    return {};
+    return item;
 }
 
-void BoardRepository::deleteItem(int columnId, int itemId) {
+void BoardRepository::deleteItem(std::int64_t columnId, std::int64_t itemId) {
+    StorageScheduler::Turn turn(scheduler);
+    std::lock_guard<std::mutex> writeLock(writeMutex);
+    RequestContext::checkDeadline();
     int result = 0;
     char *errorMessage = nullptr;
 
@@ -286,14 +300,429 @@ void BoardRepository::deleteItem(int columnId, int itemId) {
     handleSQLError(result, errorMessage);
 }
 
+std::int64_t BoardRepository::getVersion() {
+    StorageScheduler::Turn turn(scheduler);
+    int result = 0;
+    char *errorMessage = nullptr;
+
+    // autoincrement keeps the highest sequence ever handed out, even after compaction
+    string sqlSelectVersion = "select seq from sqlite_sequence where name = 'change_log'";
+    std::int64_t version = 0;
+
+    result = sqlite3_exec(database, sqlSelectVersion.c_str(), versionCallback, &version, &errorMessage);
+    handleSQLError(result, errorMessage);
+
+    return version;
+}
+
+std::int64_t BoardRepository::peekVersion() {
+    std::lock_guard<std::mutex> lock(versionCheckMutex);
+
+    // without a connection of its own the board's handle has to answer
+    if (selectDataVersion == nullptr) {
+        return getVersion();
+    }
+
+    // data_version changes with every commit of another connection, this
+    // board's handle included. the version itself is only read then
+    std::int64_t currentDataVersion = dataVersion;
+    if (sqlite3_step(selectDataVersion) == SQLITE_ROW) {
+        currentDataVersion = sqlite3_column_int64(selectDataVersion, 0);
+    }
+    sqlite3_reset(selectDataVersion);
+
+    if (currentDataVersion != dataVersion) {
+        dataVersion = currentDataVersion;
+
+        if (sqlite3_step(selectVersion) == SQLITE_ROW) {
+            knownVersion = sqlite3_column_int64(selectVersion, 0);
+        }
+        sqlite3_reset(selectVersion);
+    }
+
+    return knownVersion;
+}
+
+void BoardRepository::openVersionConnection() {
+    // only used under versionCheckMutex, the connection needs no mutex of its own
+    if (sqlite3_open_v2(databasePath.c_str(), &versionDatabase, SQLITE_OPEN_READONLY | SQLITE_OPEN_NOMUTEX, nullptr) != SQLITE_OK ||
+        sqlite3_prepare_v2(versionDatabase, "pragma data_version", -1, &selectDataVersion, nullptr) != SQLITE_OK ||
+        sqlite3_prepare_v2(versionDatabase, "select seq from sqlite_sequence where name = 'change_log'", -1, &selectVersion, nullptr) != SQLITE_OK) {
+        CROW_LOG_WARNING << "Cannot open version connection of " << databasePath << ": " << sqlite3_errmsg(versionDatabase);
+
+        sqlite3_finalize(selectDataVersion);
+        sqlite3_finalize(selectVersion);
+        sqlite3_close(versionDatabase);
+        versionDatabase = nullptr;
+        selectDataVersion = nullptr;
+        selectVersion = nullptr;
+    }
+}
+
+std::optional<ChangeSet> BoardRepository::getChangesSince(std::int64_t version) {
+    StorageScheduler::Turn turn(scheduler);
+
+    string sqlSelectChanges = "select seq, entity, operation, column_id, entity_id, name, position, created, date "
+                              "from change_log where seq > " +
+                              std::to_string(version) + " order by seq";
+    ChangeSet changes(version);
+
+    if (!selectRows(sqlSelectChanges, [&changes](sqlite3_stmt *statement) { changes.addChange(readChange(statement)); })) {
+        return {};
+    }
+
+    // sequence numbers are gap free, so a missing successor means the log
+    // was compacted past the requested version
+    if (changes.getChanges().empty()) {
+        if (version < 0 || version > getVersion()) {
+            return {};
+        }
+    } else if (changes.getChanges().front().getSequence() != version + 1) {
+        return {};
+    }
+
+    return changes;
+}
+
+std::vector<SearchHit> BoardRepository::searchItems(std::string query, int limit, int offset) {
+    string fullTextQuery = toFullTextQuery(query);
+    if (fullTextQuery.empty()) {
+        return {};
+    }
+
+    StorageScheduler::Turn turn(scheduler);
+
+    // fts5 hands out its matches in rank order, so the join with item stops
+    // after the page and the result needs no sorting of its own
+    string sqlSearchItems = "select item.id, item.title, item.position, item.created, item.date, item.column_id "
+                            "from item_fts join item on item.id = item_fts.rowid "
+                            "where item_fts match ?1 order by item_fts.rank limit ?2 offset ?3";
+
+    // unlike the other queries the search text is user input, so it is bound instead of concatenated
+    sqlite3_stmt *statement = nullptr;
+    int result = sqlite3_prepare_v2(database, sqlSearchItems.c_str(), -1, &statement, nullptr);
+
+    std::vector<SearchHit> hits;
+
+    if (result == SQLITE_OK) {
+        sqlite3_bind_text(statement, 1, fullTextQuery.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_int(statement, 2, limit);
+        sqlite3_bind_int(statement, 3, offset);
+
+        while ((result = sqlite3_step(statement)) == SQLITE_ROW) {
+            hits.emplace_back(sqlite3_column_int64(statement, 5), readItem(statement, 0));
+        }
+    }
+
+    sqlite3_finalize(statement);
+
+    if (result == SQLITE_INTERRUPT) {
+        throw DeadlineExceededException();
+    }
+
+    if (result != SQLITE_DONE) {
+        cout << "SQL error: " << sqlite3_errmsg(database) << endl;
+    }
+
+    return hits;
+}
+
+std::string BoardRepository::toFullTextQuery(std::string const &query) {
+    // every word becomes a quoted fts5 string, so operators and punctuation in
+    // the user's text cannot break the match expression. words are and-ed and
+    // the last one matches as a prefix, which suits search-as-you-type. one
+    // letter prefixes would have to rank a large part of the board, so they
+    // only match whole words
+    string fullTextQuery;
+    string word;
+    string lastWord;
+    std::istringstream words(query);
+
+    while (words >> word) {
+        lastWord = word;
+
+        if (!fullTextQuery.empty()) {
+            fullTextQuery += " ";
+        }
+
+        fullTextQuery += "\"";
+        for (char c : word) {
+            fullTextQuery += c;
+            if (c == '"') {
+                fullTextQuery += '"';
+            }
+        }
+        fullTextQuery += "\"";
+    }
+
+    if (lastWord.size() > 1) {
+        fullTextQuery += "*";
+    }
+
+    return fullTextQuery;
+}
+
+std::vector<ArchivedItem> BoardRepository::getArchivedItems(int limit, int offset) {
+    StorageScheduler::Turn turn(scheduler);
+
+    string sqlSelectArchivedItems = "select id, title, position, created, date, column_id, column_name, archived "
+                                    "from item_archive order by archived desc, id desc limit " +
+                                    std::to_string(limit) + " offset " + std::to_string(offset);
+    std::vector<ArchivedItem> archivedItems;
+
+    selectRows(sqlSelectArchivedItems, [&archivedItems](sqlite3_stmt *statement) {
+        archivedItems.emplace_back(readItem(statement, 0), sqlite3_column_int64(statement, 5),
+                                   reinterpret_cast<char const *>(sqlite3_column_text(statement, 6)),
+                                   sqlite3_column_int64(statement, 7));
+    });
+
+    return archivedItems;
+}
+
+int BoardRepository::archiveItems(ArchivePolicy const &policy) {
+    if (policy.columnNames.empty()) {
+        return 0;
+    }
+
+    std::int64_t const now = time(0);
+    std::int64_t const cutoff = now - policy.maxAge.count();
+
+    string columnPlaceholders;
+    for (size_t i = 0; i < policy.columnNames.size(); i++) {
+        columnPlaceholders += (i == 0) ? "?" : ", ?";
+    }
+
+    string sqlSelectStaleItems = "select item.id from item join column on column.id = item.column_id "
+                                 "where column.name in (" +
+                                 columnPlaceholders +
+                                 ") and item.modified > 0 and item.modified < ? limit " +
+                                 std::to_string(ARCHIVE_BATCH_SIZE);
+    int archived = 0;
+
+    // small batches, each in its own transaction, so interactive writes only
+    // ever wait for one batch and not for the whole archive run
+    while (true) {
+        StorageScheduler::Turn turn(scheduler);
+        std::lock_guard<std::mutex> writeLock(writeMutex);
+
+        std::vector<std::int64_t> itemIds;
+        sqlite3_stmt *statement = nullptr;
+
+        if (sqlite3_prepare_v2(database, sqlSelectStaleItems.c_str(), -1, &statement, nullptr) == SQLITE_OK) {
+            int parameter = 1;
+            for (auto const &columnName : policy.columnNames)
+                sqlite3_bind_text(statement, parameter++, columnName.c_str(), -1, SQLITE_TRANSIENT);
+            sqlite3_bind_int64(statement, parameter, cutoff);
+
+            while (sqlite3_step(statement) == SQLITE_ROW)
+                itemIds.push_back(sqlite3_column_int64(statement, 0));
+        }
+        sqlite3_finalize(statement);
+
+        if (itemIds.empty()) {
+            break;
+        }
+
+        string idList;
+        for (auto itemId : itemIds)
+            idList += (idList.empty() ? "" : ",") + std::to_string(itemId);
+
+        string sqlArchiveItems =
+            "begin immediate;"
+            "insert or replace into item_archive (id, title, date, created, position, column_id, column_name, archived) "
+            "select item.id, item.title, item.date, item.created, item.position, item.column_id, column.name, " +
+            std::to_string(now) +
+            " from item join column on column.id = item.column_id where item.id in (" + idList + ");" +
+            "delete from item where id in (" + idList + ");" +
+            "commit;";
+
+        char *errorMessage = nullptr;
+        int result = sqlite3_exec(database, sqlArchiveItems.c_str(), NULL, 0, &errorMessage);
+
+        if (result != SQLITE_OK) {
+            handleSQLError(result, errorMessage);
+            sqlite3_exec(database, "rollback;", NULL, 0, nullptr);
+            break;
+        }
+
+        archived += static_cast<int>(itemIds.size());
+
+        if (static_cast<int>(itemIds.size()) < ARCHIVE_BATCH_SIZE) {
+            break;
+        }
+    }
+
+    return archived;
+}
+
+bool BoardRepository::backup(std::string const &targetFile, int pagesPerStep, std::chrono::milliseconds pause,
+                             std::function<void(int, int)> const &progress) {
+    // written next to the target and renamed at the end, so an existing
+    // backup is never replaced by a partial one
+    string partialFile = targetFile + ".partial";
+    sqlite3 *target = nullptr;
+
+    int result = sqlite3_open(partialFile.c_str(), &target);
+
+    if (result == SQLITE_OK) {
+        // going through our own handle means writes of this service are applied
+        // to the copy as they happen instead of restarting the backup
+        sqlite3_backup *backup = sqlite3_backup_init(target, "main", database, "main");
+
+        if (backup) {
+            do {
+                {
+                    StorageScheduler::Turn turn(scheduler);
+                    result = sqlite3_backup_step(backup, pagesPerStep);
+                }
+                progress(sqlite3_backup_remaining(backup), sqlite3_backup_pagecount(backup));
+
+                if (result == SQLITE_OK || result == SQLITE_BUSY || result == SQLITE_LOCKED) {
+                    std::this_thread::sleep_for(pause);
+                }
+            } while (result == SQLITE_OK || result == SQLITE_BUSY || result == SQLITE_LOCKED);
+
+            sqlite3_backup_finish(backup);
+        } else {
+            result = sqlite3_errcode(target);
+        }
+    }
+
+    if (result != SQLITE_DONE) {
+        cout << "Backup to " << targetFile << " failed: " << sqlite3_errmsg(target) << endl;
+    }
+    sqlite3_close(target);
+
+    std::error_code errorCode;
+    if (result == SQLITE_DONE) {
+        filesystem::rename(partialFile, targetFile, errorCode);
+    } else {
+        filesystem::remove(partialFile, errorCode);
+    }
+
+    return result == SQLITE_DONE && !errorCode;
+}
+
+void BoardRepository::configure(StorageOptions const &options) {
+    char *errorMessage = nullptr;
+
+    string sqlConfigure = "pragma cache_size = " + std::to_string(options.cacheSize) + ";"
+                          "pragma mmap_size = " + std::to_string(options.mmapSize) + ";"
+                          "pragma synchronous = " + options.synchronous + ";";
+
+    int result = sqlite3_exec(database, sqlConfigure.c_str(), NULL, 0, &errorMessage);
+    handleSQLError(result, errorMessage);
+}
+
+StorageStatistics BoardRepository::getStorageStatistics() {
+    StorageStatistics statistics;
+    int current = 0;
+    int highwater = 0;
+
+    // the admin routes run without a request scope, so like backup steps this
+    // waits behind the board's interactive reads and writes as bulk work
+    StorageScheduler::Turn turn(scheduler);
+
+    sqlite3_db_status(database, SQLITE_DBSTATUS_CACHE_USED, &current, &highwater, 0);
+    statistics.cacheUsedBytes = current;
+    sqlite3_db_status(database, SQLITE_DBSTATUS_CACHE_HIT, &current, &highwater, 0);
+    statistics.cacheHits = current;
+    sqlite3_db_status(database, SQLITE_DBSTATUS_CACHE_MISS, &current, &highwater, 0);
+    statistics.cacheMisses = current;
+    sqlite3_db_status(database, SQLITE_DBSTATUS_CACHE_WRITE, &current, &highwater, 0);
+    statistics.cacheWrites = current;
+    sqlite3_db_status(database, SQLITE_DBSTATUS_CACHE_SPILL, &current, &highwater, 0);
+    statistics.cacheSpills = current;
+    sqlite3_db_status(database, SQLITE_DBSTATUS_SCHEMA_USED, &current, &highwater, 0);
+    statistics.schemaBytes = current;
+    sqlite3_db_status(database, SQLITE_DBSTATUS_STMT_USED, &current, &highwater, 0);
+    statistics.statementBytes = current;
+    sqlite3_db_status(database, SQLITE_DBSTATUS_LOOKASIDE_USED, &current, &highwater, 0);
+    statistics.lookasideUsed = current;
+    statistics.lookasideHighwater = highwater;
+
+    statistics.pageSize = getPragma("page_size");
+    statistics.pageCount = getPragma("page_count");
+    statistics.freelistCount = getPragma("freelist_count");
+    statistics.cacheSize = getPragma("cache_size");
+    statistics.mmapSize = getPragma("mmap_size");
+
+    std::error_code errorCode;
+    string databaseFile = sqlite3_db_filename(database, "main");
+
+    auto databaseBytes = filesystem::file_size(databaseFile, errorCode);
+    statistics.databaseBytes = errorCode ? 0 : databaseBytes;
+    auto walBytes = filesystem::file_size(databaseFile + "-wal", errorCode);
+    statistics.walBytes = errorCode ? 0 : walBytes;
+
+    return statistics;
+}
+
+std::int64_t BoardRepository::getPragma(std::string const &name) {
+    sqlite3_stmt *statement = nullptr;
+    std::int64_t value = 0;
+    string sqlPragma = "pragma " + name;
+
+    if (sqlite3_prepare_v2(database, sqlPragma.c_str(), -1, &statement, nullptr) == SQLITE_OK) {
+        if (sqlite3_step(statement) == SQLITE_ROW) {
+            value = sqlite3_column_int64(statement, 0);
+        }
+    }
+    sqlite3_finalize(statement);
+
+    return value;
+}
+
+void BoardRepository::configureScheduling(SchedulingOptions const &options, MetricsRegistry *metrics) {
+    scheduler.configure(options, metrics);
+}
+
+void BoardRepository::enableProfiling(QueryProfiler &profiler) {
+    profiler.attach(database);
+}
+
 void BoardRepository::handleSQLError(int statementResult, char *errorMessage) {
 
+    // interrupted by progressCallback, whatever was read is incomplete
+    if (statementResult == SQLITE_INTERRUPT) {
+        sqlite3_free(errorMessage);
+        throw DeadlineExceededException();
+    }
+
     if (statementResult != SQLITE_OK) {
         cout << "SQL error: " << errorMessage << endl;
         sqlite3_free(errorMessage);
     }
 }
 
+bool BoardRepository::selectRows(std::string const &sqlSelect, std::function<void(sqlite3_stmt *)> const &readRow) {
+    sqlite3_stmt *statement = nullptr;
+    int result = sqlite3_prepare_v2(database, sqlSelect.c_str(), -1, &statement, nullptr);
+
+    if (result == SQLITE_OK) {
+        while ((result = sqlite3_step(statement)) == SQLITE_ROW) {
+            readRow(statement);
+        }
+    }
+
+    sqlite3_finalize(statement);
+
+    if (result == SQLITE_INTERRUPT) {
+        throw DeadlineExceededException();
+    }
+
+    if (result != SQLITE_DONE) {
+        cout << "SQL error: " << sqlite3_errmsg(database) << endl;
+        return false;
+    }
+
+    return true;
+}
+
+int BoardRepository::progressCallback(void *) {
+    return RequestContext::current().isExpired() ? 1 : 0;
+}
+
 void BoardRepository::createDummyData() {
 
     cout << "creatingDummyData ..." << endl;
@@ -322,46 +751,76 @@ void BoardRepository::createDummyData() {
     handleSQLError(result, errorMessage);
 }
 
-int BoardRepository::allItemsCallback(void *data, int numberOfColumns, char **fieldValues, char **columnNames) {
+int BoardRepository::allColumnsCallback(void *data, int, char **fieldValues, char **) {
     if (data && fieldValues) {
-        auto items = static_cast<vector<Item> *>(data);
+        auto columns = static_cast<vector<Column> *>(data);
 
-        items->emplace_back(stoi(fieldValues[0]), fieldValues[1], stoi(fieldValues[2]), fieldValues[3]);
+        columns->emplace_back(stoll(fieldValues[0]), fieldValues[1], stoi(fieldValues[2]));
     }
 
     return 0;
 }
 
-int BoardRepository::allColumnsCallback(void *data, int numberOfColumns, char **fieldValues, char **columnNames) {
+int BoardRepository::columnCallback(void *data, int, char **fieldValues, char **) {
     if (data && fieldValues) {
-        auto columns = static_cast<vector<Column> *>(data);
+        auto column = static_cast<Column *>(data);
 
-        columns->emplace_back(stoi(fieldValues[0]), fieldValues[1], stoi(fieldValues[2]));
+        column->setID(stoll(fieldValues[0]));
+        column->setName(fieldValues[1]);
+        column->setPos(stoi(fieldValues[2]));
     }
 
     return 0;
 }
 
-int BoardRepository::itemCallback(void *data, int numberOfColumns, char **fieldValues, char **columnNames) {
-    if (data && fieldValues) {
-        auto item = static_cast<Item *>(data);
+Item BoardRepository::readItem(sqlite3_stmt *statement, int firstColumn) {
+    // id, title, position, created, date from firstColumn on. created is null
+    // for rows other tools wrote, those keep their date text as it is
+    Item item(sqlite3_column_int64(statement, firstColumn),
+              reinterpret_cast<char const *>(sqlite3_column_text(statement, firstColumn + 1)),
+              sqlite3_column_int(statement, firstColumn + 2), sqlite3_column_int64(statement, firstColumn + 3));
 
-        item->setID(stoi(fieldValues[0]));
-        item->setTitle(fieldValues[1]);
-        item->setTimestamp(fieldValues[3]);
-        item->setPos(stoi(fieldValues[2]));
+    if (sqlite3_column_type(statement, firstColumn + 3) == SQLITE_NULL) {
+        auto date = reinterpret_cast<char const *>(sqlite3_column_text(statement, firstColumn + 4));
+        item.setDateText(date ? date : "");
     }
 
-    return 0;
+    return item;
+}
+
+Change BoardRepository::readChange(sqlite3_stmt *statement) {
+    // seq, entity, operation, column_id and then the entity as readItem reads it
+    auto entityName = reinterpret_cast<char const *>(sqlite3_column_text(statement, 1));
+    auto operationName = reinterpret_cast<char const *>(sqlite3_column_text(statement, 2));
+
+    auto entity = strcmp(entityName, "column") == 0 ? Change::Entity::Column : Change::Entity::Item;
+    auto operation = Change::Operation::Delete;
+    if (strcmp(operationName, "insert") == 0) {
+        operation = Change::Operation::Insert;
+    } else if (strcmp(operationName, "update") == 0) {
+        operation = Change::Operation::Update;
+    }
+
+    Change change(sqlite3_column_int64(statement, 0), entity, operation, sqlite3_column_int64(statement, 4),
+                  sqlite3_column_int64(statement, 3));
+
+    if (operation != Change::Operation::Delete) {
+        if (entity == Change::Entity::Column) {
+            change.setColumn(Column(change.getId(), reinterpret_cast<char const *>(sqlite3_column_text(statement, 5)),
+                                    sqlite3_column_int(statement, 6)));
+        } else {
+            change.setItem(readItem(statement, 4));
+        }
+    }
+
+    return change;
 }
 
-int BoardRepository::columnCallback(void *data, int numberOfColumns, char **fieldValues, char **columnNames) {
+int BoardRepository::versionCallback(void *data, int, char **fieldValues, char **) {
     if (data && fieldValues) {
-        auto column = static_cast<Column *>(data);
+        auto version = static_cast<std::int64_t *>(data);
 
-        column->setID(stoi(fieldValues[0]));
-        column->setName(fieldValues[1]);
-        column->setPos(stoi(fieldValues[2]));
+        *version = stoll(fieldValues[0]);
     }
 
     return 0;
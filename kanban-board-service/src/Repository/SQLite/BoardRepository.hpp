@@ -1,44 +1,106 @@
 #pragma once
 
+#include "ArchivePolicy.hpp"
+#include "QueryProfiler.hpp"
+#include "StorageOptions.hpp"
+#include "StorageScheduler.hpp"
+#include "StorageStatistics.hpp"
 #include "Repository/RepositoryIf.hpp"
 #include "sqlite3.h"
+#include <chrono>
+#include <functional>
+#include <mutex>
 
 namespace Prog3 {
 namespace Repository {
 namespace SQLite {
 
-class BoardRepository : public RepositoryIf {
+class BoardRepository final : public RepositoryIf {
   private:
     sqlite3 *database;
+    std::string databasePath;
+    std::string shardTitle;
+
+    // every board has its own database handle, writes to one board never wait for another
+    std::mutex writeMutex;
+    // decides which of the requests waiting for the handle runs next
+    StorageScheduler scheduler;
+
+    // what peekVersion answers, read through pragma data_version on a read
+    // only connection of its own, so it never waits for the board's handle
+    std::mutex versionCheckMutex;
+    sqlite3 *versionDatabase;
+    sqlite3_stmt *selectDataVersion;
+    sqlite3_stmt *selectVersion;
+    std::int64_t dataVersion;
+    std::int64_t knownVersion;
+
+    void openVersionConnection();
 
     void initialize();
     void createDummyData();
     void handleSQLError(int statementResult, char *errorMessage);
+    bool selectRows(std::string const &sqlSelect, std::function<void(sqlite3_stmt *)> const &readRow);
+    // the caller holds a turn of the scheduler
+    std::int64_t getPragma(std::string const &name);
 
-    static bool isValid(int id) {
+    static std::string toFullTextQuery(std::string const &query);
+
+    static bool isValid(std::int64_t id) {
         return id != INVALID_ID;
     }
 
-    static int allItemsCallback(void *data, int numberOfColumns, char **fieldValues, char **columnNames);
+    static int progressCallback(void *data);
     static int allColumnsCallback(void *data, int numberOfColumns, char **fieldValues, char **columnNames);
-    static int itemCallback(void *data, int numberOfColumns, char **fieldValues, char **columnNames);
     static int columnCallback(void *data, int numberOfColumns, char **fieldValues, char **columnNames);
+    static Prog3::Core::Model::Item readItem(sqlite3_stmt *statement, int firstColumn);
+    static Prog3::Core::Model::Change readChange(sqlite3_stmt *statement);
+    static int versionCallback(void *data, int numberOfColumns, char **fieldValues, char **columnNames);
 
   public:
     BoardRepository();
+    BoardRepository(std::string givenDatabaseFile, std::string givenTitle);
     virtual ~BoardRepository();
 
     virtual Prog3::Core::Model::Board getBoard();
     virtual std::vector<Prog3::Core::Model::Column> getColumns();
-    virtual std::optional<Prog3::Core::Model::Column> getColumn(int id);
+    virtual std::optional<Prog3::Core::Model::Column> getColumn(std::int64_t id);
     virtual std::optional<Prog3::Core::Model::Column> postColumn(std::string name, int position);
-    virtual std::optional<Prog3::Core::Model::Column> putColumn(int id, std::string name, int position);
-    virtual void deleteColumn(int id);
-    virtual std::vector<Prog3::Core::Model::Item> getItems(int columnId);
-    virtual std::optional<Prog3::Core::Model::Item> getItem(int columnId, int itemId);
-    virtual std::optional<Prog3::Core::Model::Item> postItem(int columnId, std::string title, int position);
-    virtual std::optional<Prog3::Core::Model::Item> putItem(int columnId, int itemId, std::string title, int position);
-    virtual void deleteItem(int columnId, int itemId);
+    virtual std::optional<Prog3::Core::Model::Column> putColumn(std::int64_t id, std::string name, int position);
+    virtual void deleteColumn(std::int64_t id);
+    virtual std::vector<Prog3::Core::Model::Item> getItems(std::int64_t columnId);
+    virtual std::optional<Prog3::Core::Model::Item> getItem(std::int64_t columnId, std::int64_t itemId);
+    virtual std::optional<Prog3::Core::Model::Item> postItem(std::int64_t columnId, std::string title, int position);
+    virtual std::optional<Prog3::Core::Model::Item> putItem(std::int64_t columnId, std::int64_t itemId, std::string title, int position);
+    virtual void deleteItem(std::int64_t columnId, std::int64_t itemId);
+
+    virtual std::int64_t getVersion();
+    virtual std::int64_t peekVersion();
+    virtual std::optional<Prog3::Core::Model::ChangeSet> getChangesSince(std::int64_t version);
+
+    virtual std::vector<Prog3::Core::Model::SearchHit> searchItems(std::string query, int limit, int offset);
+    virtual std::vector<Prog3::Core::Model::ArchivedItem> getArchivedItems(int limit, int offset);
+
+    // moves stale items of the policy's columns into item_archive, returns how many were moved
+    int archiveItems(ArchivePolicy const &policy);
+
+    static inline int const ARCHIVE_BATCH_SIZE = 500;
+    // virtual machine instructions between two deadline checks
+    static inline int const PROGRESS_HANDLER_INSTRUCTIONS = 1000;
+
+    // online copy into targetFile using the sqlite backup api, pagesPerStep pages
+    // at a time with a pause in between so requests on this board keep flowing.
+    // progress is called after every step with (remaining pages, total pages)
+    bool backup(std::string const &targetFile, int pagesPerStep, std::chrono::milliseconds pause,
+                std::function<void(int, int)> const &progress);
+
+    void configure(StorageOptions const &options);
+    StorageStatistics getStorageStatistics();
+
+    // reports the time of every statement on this board's handle to profiler
+    void enableProfiling(QueryProfiler &profiler);
+    // queue delays are reported to metrics if it is set
+    void configureScheduling(SchedulingOptions const &options, Prog3::Core::Metrics::MetricsRegistry *metrics);
 
     static inline std::string const boardTitle = "Kanban Board";
     static inline int const INVALID_ID = -1;
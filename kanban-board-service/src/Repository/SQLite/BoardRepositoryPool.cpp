@@ -0,0 +1,163 @@
+#include "BoardRepositoryPool.hpp"
+#include "Core/Exception/TooManyBoardsException.hpp"
+#include "crow/logging.h"
+#include <filesystem>
+
+using namespace Prog3::Repository::SQLite;
+using namespace std;
+
+BoardRepositoryPool::BoardRepositoryPool() : BoardRepositoryPool(getDefaultShardDirectory(BoardRepository::databaseFile)) {
+}
+
+BoardRepositoryPool::BoardRepositoryPool(std::string givenShardDirectory) : BoardRepositoryPool(BoardRepository::databaseFile, givenShardDirectory) {
+}
+
+BoardRepositoryPool::BoardRepositoryPool(std::string givenDatabaseFile, std::string givenShardDirectory)
+    : databaseFile(givenDatabaseFile), shardDirectory(givenShardDirectory), profiler(nullptr), metrics(nullptr),
+      maxOpenBoards(DEFAULT_MAX_OPEN_BOARDS) {
+    // the default board is opened right away so its schema is in place at startup
+    createRepository(DEFAULT_BOARD_ID);
+}
+
+BoardRepository *BoardRepositoryPool::getRepository(int boardId) {
+    BoardRepository *existing = findOpenRepository(boardId);
+    if (existing) {
+        return existing;
+    }
+
+    return openRepository(boardId, false);
+}
+
+BoardRepository &BoardRepositoryPool::createRepository(int boardId) {
+    BoardRepository *existing = findOpenRepository(boardId);
+    if (existing) {
+        return *existing;
+    }
+
+    return *openRepository(boardId, true);
+}
+
+BoardRepository *BoardRepositoryPool::findOpenRepository(int boardId) {
+    std::shared_lock<std::shared_mutex> lock(repositoriesMutex);
+
+    auto existing = repositories.find(boardId);
+    return (existing != repositories.end()) ? existing->second.get() : nullptr;
+}
+
+BoardRepository *BoardRepositoryPool::openRepository(int boardId, bool create) {
+    std::string file = getDatabaseFile(boardId);
+    {
+        std::unique_lock<std::mutex> lock(openingMutex);
+        // another request may be opening the board already, it is opened once
+        openingDone.wait(lock, [this, boardId]() { return opening.count(boardId) == 0; });
+
+        BoardRepository *existing = findOpenRepository(boardId);
+        if (existing) {
+            return existing;
+        }
+
+        if (!create && !filesystem::exists(file)) {
+            return nullptr;
+        }
+
+        std::shared_lock<std::shared_mutex> repositoriesLock(repositoriesMutex);
+        if (repositories.size() + opening.size() >= maxOpenBoards) {
+            CROW_LOG_WARNING << "Not opening board " << boardId << ", " << maxOpenBoards << " boards are open";
+            throw Prog3::Core::Exception::TooManyBoardsException();
+        }
+
+        opening.insert(boardId);
+    }
+
+    std::unique_ptr<BoardRepository> repository;
+    try {
+        repository = std::make_unique<BoardRepository>(file, getBoardTitle(boardId));
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(openingMutex);
+        opening.erase(boardId);
+        openingDone.notify_all();
+        throw;
+    }
+
+    auto &inserted = *repository;
+    {
+        std::unique_lock<std::shared_mutex> lock(repositoriesMutex);
+
+        inserted.configure(storageOptions);
+        inserted.configureScheduling(schedulingOptions, metrics);
+        if (profiler) {
+            inserted.enableProfiling(*profiler);
+        }
+        repositories.emplace(boardId, std::move(repository));
+    }
+
+    std::lock_guard<std::mutex> lock(openingMutex);
+    opening.erase(boardId);
+    openingDone.notify_all();
+
+    return &inserted;
+}
+
+void BoardRepositoryPool::forEachRepository(std::function<void(int boardId, BoardRepository &repository)> const &action) {
+    std::vector<std::pair<int, BoardRepository *>> openRepositories;
+    {
+        std::shared_lock<std::shared_mutex> lock(repositoriesMutex);
+        for (auto &entry : repositories)
+            openRepositories.emplace_back(entry.first, entry.second.get());
+    }
+
+    // repositories are never closed before the pool, so the action can run unlocked
+    for (auto &entry : openRepositories)
+        action(entry.first, *entry.second);
+}
+
+void BoardRepositoryPool::setQueryProfiler(QueryProfiler &givenProfiler) {
+    std::unique_lock<std::shared_mutex> lock(repositoriesMutex);
+
+    profiler = &givenProfiler;
+    for (auto &entry : repositories)
+        entry.second->enableProfiling(givenProfiler);
+}
+
+void BoardRepositoryPool::setStorageOptions(StorageOptions givenStorageOptions) {
+    std::unique_lock<std::shared_mutex> lock(repositoriesMutex);
+
+    storageOptions = givenStorageOptions;
+    for (auto &entry : repositories)
+        entry.second->configure(storageOptions);
+}
+
+void BoardRepositoryPool::setScheduling(SchedulingOptions givenSchedulingOptions, Prog3::Core::Metrics::MetricsRegistry &givenMetrics) {
+    std::unique_lock<std::shared_mutex> lock(repositoriesMutex);
+
+    schedulingOptions = givenSchedulingOptions;
+    metrics = &givenMetrics;
+    for (auto &entry : repositories)
+        entry.second->configureScheduling(schedulingOptions, metrics);
+}
+
+void BoardRepositoryPool::setMaxOpenBoards(std::size_t givenMaxOpenBoards) {
+    std::lock_guard<std::mutex> lock(openingMutex);
+
+    maxOpenBoards = givenMaxOpenBoards;
+}
+
+std::string BoardRepositoryPool::getDefaultShardDirectory(std::string const &databaseFile) {
+    return (filesystem::path(databaseFile).parent_path() / "boards").string();
+}
+
+std::string BoardRepositoryPool::getDatabaseFile(int boardId) const {
+    if (boardId == DEFAULT_BOARD_ID) {
+        return databaseFile;
+    }
+
+    return (filesystem::path(shardDirectory) / ("kanban-board-" + to_string(boardId) + ".db")).string();
+}
+
+std::string BoardRepositoryPool::getBoardTitle(int boardId) {
+    if (boardId == DEFAULT_BOARD_ID) {
+        return BoardRepository::boardTitle;
+    }
+
+    return BoardRepository::boardTitle + " " + to_string(boardId);
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "BoardRepository.hpp"
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <memory>
+#include <set>
+#include <shared_mutex>
+
+namespace Prog3 {
+namespace Repository {
+namespace SQLite {
+
+// Owns one BoardRepository (and with it one SQLite file) per board.
+// Board 0 is the original single board in databaseFile (by default
+// BoardRepository::databaseFile), every other board is sharded into its own
+// file below shardDirectory. A board exists once its file does, only
+// createRepository makes new files.
+class BoardRepositoryPool {
+  private:
+    std::string databaseFile;
+    std::string shardDirectory;
+    QueryProfiler *profiler;
+    StorageOptions storageOptions;
+    SchedulingOptions schedulingOptions;
+    Prog3::Core::Metrics::MetricsRegistry *metrics;
+
+    std::shared_mutex repositoriesMutex;
+    std::map<int, std::unique_ptr<BoardRepository>> repositories;
+
+    // boards being opened right now. they are opened (and migrated) outside
+    // repositoriesMutex, so the boards already open keep serving meanwhile
+    std::mutex openingMutex;
+    std::condition_variable openingDone;
+    std::set<int> opening;
+    std::size_t maxOpenBoards;
+
+    BoardRepository *findOpenRepository(int boardId);
+    BoardRepository *openRepository(int boardId, bool create);
+
+  public:
+    BoardRepositoryPool();
+    BoardRepositoryPool(std::string givenShardDirectory);
+    BoardRepositoryPool(std::string givenDatabaseFile, std::string givenShardDirectory);
+    ~BoardRepositoryPool() {}
+
+    // the board's repository, its file is opened (and migrated) on first use.
+    // nullptr if the board has no file. both throw TooManyBoardsException
+    // instead of opening more than maxOpenBoards boards
+    BoardRepository *getRepository(int boardId);
+    // like getRepository, but creates the board's file if it has none
+    BoardRepository &createRepository(int boardId);
+    void forEachRepository(std::function<void(int boardId, BoardRepository &repository)> const &action);
+
+    // applied to the open boards and to every board opened later
+    void setQueryProfiler(QueryProfiler &givenProfiler);
+    void setStorageOptions(StorageOptions givenStorageOptions);
+    void setScheduling(SchedulingOptions givenSchedulingOptions, Prog3::Core::Metrics::MetricsRegistry &givenMetrics);
+    // every open board holds a database handle until the service stops
+    void setMaxOpenBoards(std::size_t givenMaxOpenBoards);
+
+    std::string getDatabaseFile(int boardId) const;
+    static std::string getBoardTitle(int boardId);
+
+    // "boards" next to the default board's file
+    static std::string getDefaultShardDirectory(std::string const &databaseFile);
+
+    static inline int const DEFAULT_BOARD_ID = 0;
+    static inline std::size_t const DEFAULT_MAX_OPEN_BOARDS = 256;
+};
+
+} // namespace SQLite
+} // namespace Repository
+} // namespace Prog3
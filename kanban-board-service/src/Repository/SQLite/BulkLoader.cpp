@@ -0,0 +1,130 @@
+#include "BulkLoader.hpp"
+#include "SchemaMigrator.hpp"
+#include "Core/Model/Timestamp.hpp"
+#include <filesystem>
+#include <iostream>
+
+using namespace Prog3::Repository::SQLite;
+using namespace Prog3::Core::Model;
+using namespace std;
+
+BulkLoader::BulkLoader(std::string const &databaseFile)
+    : database(nullptr), insertColumn(nullptr), insertItem(nullptr), failed(false), open(false) {
+
+    string databaseDirectory = filesystem::path(databaseFile).parent_path().string();
+    if (!databaseDirectory.empty() && filesystem::is_directory(databaseDirectory) == false) {
+        filesystem::create_directories(databaseDirectory);
+    }
+
+    if (sqlite3_open(databaseFile.c_str(), &database) != SQLITE_OK) {
+        cout << "Cannot open database: " << sqlite3_errmsg(database) << endl;
+        failed = true;
+        return;
+    }
+
+    SchemaMigrator migrator(database);
+    if (migrator.migrate() != SchemaMigrator::getLatestVersion()) {
+        failed = true;
+        return;
+    }
+
+    // a rollback journal in memory and no syncs, the load either commits as a whole or not at all
+    execute("pragma journal_mode = memory; pragma synchronous = off; pragma cache_size = -262144;");
+
+    sqlite3_stmt *selectTriggers = nullptr;
+    string sqlSelectTriggers = string("select sql from sqlite_master where type = 'trigger' and name in (") + BULK_TRIGGERS + ")";
+    check(sqlite3_prepare_v2(database, sqlSelectTriggers.c_str(), -1, &selectTriggers, nullptr));
+    while (selectTriggers && sqlite3_step(selectTriggers) == SQLITE_ROW) {
+        triggers.emplace_back(reinterpret_cast<char const *>(sqlite3_column_text(selectTriggers, 0)));
+    }
+    sqlite3_finalize(selectTriggers);
+
+    open = execute("begin immediate;");
+    execute("drop trigger if exists column_insert_log; drop trigger if exists item_insert_log;"
+            "drop trigger if exists item_fts_insert; drop trigger if exists change_log_compact;");
+
+    check(sqlite3_prepare_v2(database, "insert into column (id, name, position) values (?, ?, ?)", -1, &insertColumn, nullptr));
+    check(sqlite3_prepare_v2(database, "insert into item (title, date, created, position, column_id, modified) values (?, ?, ?, ?, ?, ?)", -1,
+                             &insertItem, nullptr));
+}
+
+BulkLoader::~BulkLoader() {
+    sqlite3_finalize(insertColumn);
+    sqlite3_finalize(insertItem);
+
+    if (open) {
+        sqlite3_exec(database, "rollback;", NULL, 0, nullptr);
+    }
+
+    sqlite3_close(database);
+}
+
+void BulkLoader::addColumn(std::int64_t id, std::string_view name, int position) {
+    if (failed) {
+        return;
+    }
+
+    sqlite3_bind_int64(insertColumn, 1, id);
+    sqlite3_bind_text(insertColumn, 2, name.data(), static_cast<int>(name.size()), SQLITE_TRANSIENT);
+    sqlite3_bind_int(insertColumn, 3, position);
+    check(sqlite3_step(insertColumn));
+    sqlite3_reset(insertColumn);
+}
+
+void BulkLoader::addItem(std::int64_t columnId, std::string_view title, int position, std::int64_t created, std::int64_t modified) {
+    if (failed) {
+        return;
+    }
+
+    char date[32];
+    size_t dateLength = formatTimestamp(created, date, sizeof(date));
+
+    sqlite3_bind_text(insertItem, 1, title.data(), static_cast<int>(title.size()), SQLITE_TRANSIENT);
+    sqlite3_bind_text(insertItem, 2, date, static_cast<int>(dateLength), SQLITE_TRANSIENT);
+    sqlite3_bind_int64(insertItem, 3, created);
+    sqlite3_bind_int(insertItem, 4, position);
+    sqlite3_bind_int64(insertItem, 5, columnId);
+    sqlite3_bind_int64(insertItem, 6, modified);
+    check(sqlite3_step(insertItem));
+    sqlite3_reset(insertItem);
+}
+
+bool BulkLoader::finish() {
+    if (!failed) {
+        execute("insert into item_fts (item_fts) values ('rebuild');");
+        for (auto const &trigger : triggers) {
+            execute(trigger + ";");
+        }
+    }
+
+    if (failed || !execute("commit;")) {
+        return false;
+    }
+    open = false;
+
+    // the service runs its boards in wal mode
+    execute("pragma journal_mode = wal;");
+
+    return !failed;
+}
+
+bool BulkLoader::execute(std::string const &sql) {
+    char *errorMessage = nullptr;
+    int result = sqlite3_exec(database, sql.c_str(), NULL, 0, &errorMessage);
+
+    if (result != SQLITE_OK) {
+        cout << "SQL error: " << (errorMessage ? errorMessage : sqlite3_errmsg(database)) << endl;
+        sqlite3_free(errorMessage);
+        failed = true;
+        return false;
+    }
+
+    return true;
+}
+
+void BulkLoader::check(int statementResult) {
+    if (statementResult != SQLITE_OK && statementResult != SQLITE_DONE) {
+        cout << "SQL error: " << sqlite3_errmsg(database) << endl;
+        failed = true;
+    }
+}
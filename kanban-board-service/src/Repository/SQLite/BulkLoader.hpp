@@ -0,0 +1,49 @@
+#pragma once
+
+#include "sqlite3.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Prog3 {
+namespace Repository {
+namespace SQLite {
+
+// Writes columns and items into a board database in a single transaction, for
+// generated datasets and fixtures of 100k and more items. The statements are
+// prepared once, and the per row triggers of the change log and the full-text
+// index are dropped for the load. finish() restores them and rebuilds the index
+// in one pass, so the loaded rows are not in the change log. Meant for a board
+// that is not open in a running service.
+class BulkLoader {
+  private:
+    sqlite3 *database;
+    sqlite3_stmt *insertColumn;
+    sqlite3_stmt *insertItem;
+    // create statements of the dropped triggers
+    std::vector<std::string> triggers;
+    bool failed;
+    bool open;
+
+    bool execute(std::string const &sql);
+    void check(int statementResult);
+
+    static inline char const *const BULK_TRIGGERS =
+        "'column_insert_log', 'item_insert_log', 'item_fts_insert', 'change_log_compact'";
+
+  public:
+    BulkLoader(std::string const &databaseFile);
+    ~BulkLoader();
+
+    void addColumn(std::int64_t id, std::string_view name, int position);
+    // created is the unix time shown as the item's timestamp, modified the one the archive uses
+    void addItem(std::int64_t columnId, std::string_view title, int position, std::int64_t created, std::int64_t modified);
+
+    // commits the load, false if any statement failed, in which case nothing is written
+    bool finish();
+};
+
+} // namespace SQLite
+} // namespace Repository
+} // namespace Prog3
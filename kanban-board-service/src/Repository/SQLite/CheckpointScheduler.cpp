@@ -0,0 +1,126 @@
+#include "CheckpointScheduler.hpp"
+#include "crow/logging.h"
+#include <filesystem>
+#include <iostream>
+
+using namespace Prog3::Repository::SQLite;
+using namespace Prog3::Core::Metrics;
+using namespace std;
+
+CheckpointScheduler::CheckpointScheduler(BoardRepositoryPool &givenRepositoryPool, MetricsRegistry &givenMetrics, CheckpointOptions givenOptions)
+    : repositoryPool(givenRepositoryPool), metrics(givenMetrics), options(givenOptions) {
+}
+
+CheckpointScheduler::~CheckpointScheduler() {
+    for (auto &board : boards) {
+        sqlite3_close(board.second.database);
+    }
+}
+
+void CheckpointScheduler::run() {
+    repositoryPool.forEachRepository([this](int boardId, BoardRepository &) {
+        checkpointBoard(boardId);
+    });
+}
+
+void CheckpointScheduler::checkpointBoard(int boardId) {
+    BoardState &state = boards[boardId];
+
+    if (state.database == nullptr) {
+        state.database = open(boardId);
+        if (state.database == nullptr) {
+            boards.erase(boardId);
+            return;
+        }
+    }
+
+    string board = to_string(boardId);
+    std::error_code errorCode;
+    auto walSize = filesystem::file_size(repositoryPool.getDatabaseFile(boardId) + "-wal", errorCode);
+    if (errorCode) {
+        walSize = 0;
+    }
+    metrics.setGauge(MetricsRegistry::withLabel("kanban_wal_size_bytes", "board", board), walSize);
+
+    // data_version changes whenever another connection commits, including
+    // writers outside the service
+    std::int64_t dataVersion = getDataVersion(state.database);
+    bool idle = (dataVersion == state.dataVersion);
+    if (!idle) {
+        state.checkpointed = false;
+    }
+    state.dataVersion = dataVersion;
+
+    if (static_cast<std::int64_t>(walSize) > options.walLimitBytes) {
+        if (checkpoint(boardId, state, SQLITE_CHECKPOINT_TRUNCATE)) {
+            metrics.setGauge(MetricsRegistry::withLabel("kanban_wal_size_bytes", "board", board), 0);
+        }
+    } else if (idle && !state.checkpointed && walSize > 0) {
+        checkpoint(boardId, state, SQLITE_CHECKPOINT_PASSIVE);
+    }
+}
+
+bool CheckpointScheduler::checkpoint(int boardId, BoardState &state, int mode) {
+    string board = to_string(boardId);
+    string modeName = (mode == SQLITE_CHECKPOINT_TRUNCATE) ? "truncate" : "passive";
+    int walFrames = 0;
+    int checkpointedFrames = 0;
+
+    auto started = chrono::steady_clock::now();
+    // there is no busy handler on this connection: a truncating checkpoint that
+    // would have to wait for a writer or reader degrades to a passive one
+    int result = sqlite3_wal_checkpoint_v2(state.database, nullptr, mode, &walFrames, &checkpointedFrames);
+    chrono::duration<double> duration = chrono::steady_clock::now() - started;
+
+    string labels = MetricsRegistry::withLabel(MetricsRegistry::withLabel("", "board", board), "mode", modeName);
+    metrics.observe("kanban_wal_checkpoint_duration_seconds" + labels, duration.count());
+    metrics.incrementCounter("kanban_wal_checkpoints_total" + labels);
+    metrics.setGauge(MetricsRegistry::withLabel("kanban_wal_frames", "board", board), walFrames);
+
+    if (result == SQLITE_BUSY) {
+        metrics.incrementCounter("kanban_wal_checkpoints_busy_total" + labels);
+        return false;
+    }
+
+    if (result != SQLITE_OK) {
+        cout << "Checkpoint of board " << board << " failed: " << sqlite3_errmsg(state.database) << endl;
+        return false;
+    }
+
+    state.checkpointed = (walFrames == checkpointedFrames);
+
+    if (mode == SQLITE_CHECKPOINT_TRUNCATE) {
+        CROW_LOG_INFO << "Truncated wal of board " << board << " after " << duration.count() << "s";
+    }
+
+    return true;
+}
+
+sqlite3 *CheckpointScheduler::open(int boardId) {
+    sqlite3 *database = nullptr;
+    string databaseFile = repositoryPool.getDatabaseFile(boardId);
+
+    int result = sqlite3_open_v2(databaseFile.c_str(), &database, SQLITE_OPEN_READWRITE, nullptr);
+
+    if (result != SQLITE_OK) {
+        cout << "Cannot open " << databaseFile << " for checkpoints: " << sqlite3_errmsg(database) << endl;
+        sqlite3_close(database);
+        return nullptr;
+    }
+
+    return database;
+}
+
+std::int64_t CheckpointScheduler::getDataVersion(sqlite3 *database) {
+    sqlite3_stmt *statement = nullptr;
+    std::int64_t version = -1;
+
+    if (sqlite3_prepare_v2(database, "pragma data_version", -1, &statement, nullptr) == SQLITE_OK) {
+        if (sqlite3_step(statement) == SQLITE_ROW) {
+            version = sqlite3_column_int64(statement, 0);
+        }
+    }
+    sqlite3_finalize(statement);
+
+    return version;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "BoardRepositoryPool.hpp"
+#include "Core/Metrics/MetricsRegistry.hpp"
+#include "sqlite3.h"
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <string>
+
+namespace Prog3 {
+namespace Repository {
+namespace SQLite {
+
+struct CheckpointOptions {
+    // how often run() is called, a board is idle if nothing was committed in between
+    std::chrono::milliseconds interval{1000};
+    // above this size the wal is checkpointed and truncated even while the board is busy
+    std::int64_t walLimitBytes = 64 * 1024 * 1024;
+};
+
+// Replaces sqlite's automatic checkpoints (switched off in BoardRepository).
+// Every board gets its own checkpoint connection, so copying the wal back
+// into the database never holds the handle that serves requests.
+class CheckpointScheduler {
+  private:
+    struct BoardState {
+        sqlite3 *database = nullptr;
+        std::int64_t dataVersion = -1;
+        // the last checkpoint copied the whole wal and nothing was committed since
+        bool checkpointed = false;
+    };
+
+    BoardRepositoryPool &repositoryPool;
+    Prog3::Core::Metrics::MetricsRegistry &metrics;
+    CheckpointOptions options;
+
+    std::map<int, BoardState> boards;
+
+    void checkpointBoard(int boardId);
+    bool checkpoint(int boardId, BoardState &state, int mode);
+    sqlite3 *open(int boardId);
+
+    static std::int64_t getDataVersion(sqlite3 *database);
+
+  public:
+    CheckpointScheduler(BoardRepositoryPool &givenRepositoryPool, Prog3::Core::Metrics::MetricsRegistry &givenMetrics, CheckpointOptions givenOptions);
+    ~CheckpointScheduler();
+
+    CheckpointOptions const &getOptions() const {
+        return options;
+    }
+
+    // one scheduling round over all open boards, not thread safe
+    void run();
+};
+
+} // namespace SQLite
+} // namespace Repository
+} // namespace Prog3
@@ -0,0 +1,244 @@
+#include "QueryProfiler.hpp"
+#include "crow/logging.h"
+#include <algorithm>
+#include <cctype>
+#include <functional>
+
+using namespace Prog3::Repository::SQLite;
+using namespace std;
+
+QueryProfiler::QueryProfiler(std::chrono::milliseconds givenSlowThreshold) : slowThreshold(givenSlowThreshold) {
+}
+
+QueryProfiler::~QueryProfiler() {
+    for (auto &connection : explainConnections) {
+        sqlite3_close(connection.second);
+    }
+}
+
+void QueryProfiler::attach(sqlite3 *database) {
+    sqlite3_trace_v2(database, SQLITE_TRACE_STMT | SQLITE_TRACE_PROFILE, traceCallback, this);
+}
+
+namespace {
+
+// statements that are running on this thread and when they started. sqlite
+// reports elapsed times in whole milliseconds on most platforms, which rounds
+// almost every statement of this service down to zero
+thread_local std::vector<std::pair<void *, std::chrono::steady_clock::time_point>> runningStatements;
+
+// the normalized text of the statements this thread ran last. prepared
+// statements run many times with the same text, their text is normalized once
+struct NormalizedStatement {
+    sqlite3_stmt *statement;
+    std::string sql;
+    std::string normalized;
+    size_t shard;
+};
+
+thread_local std::vector<NormalizedStatement> normalizedStatements;
+thread_local size_t nextNormalizedStatement = 0;
+
+} // namespace
+
+int QueryProfiler::traceCallback(unsigned type, void *context, void *statement, void *elapsed) {
+    auto running = std::find_if(runningStatements.begin(), runningStatements.end(), [statement](auto const &entry) {
+        return entry.first == statement;
+    });
+
+    if (type == SQLITE_TRACE_STMT) {
+        // also called when a trigger of the statement starts, the first call counts
+        if (running == runningStatements.end()) {
+            // a statement that failed before it finished never reports a profile
+            if (runningStatements.size() >= MAX_RUNNING_STATEMENTS) {
+                runningStatements.clear();
+            }
+            runningStatements.emplace_back(statement, std::chrono::steady_clock::now());
+        }
+    } else if (type == SQLITE_TRACE_PROFILE) {
+        std::int64_t nanoseconds = *static_cast<sqlite3_int64 *>(elapsed);
+
+        if (running != runningStatements.end()) {
+            nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - running->second).count();
+            runningStatements.erase(running);
+        }
+
+        auto profiler = static_cast<QueryProfiler *>(context);
+        profiler->record(static_cast<sqlite3_stmt *>(statement), nanoseconds);
+    }
+
+    return 0;
+}
+
+void QueryProfiler::record(sqlite3_stmt *statement, std::int64_t nanoseconds) {
+    char const *sql = sqlite3_sql(statement);
+    if (sql == nullptr) {
+        return;
+    }
+
+    // a finalized statement's address can come back for another text, so the text is compared as well
+    auto cached = std::find_if(normalizedStatements.begin(), normalizedStatements.end(), [statement, sql](auto const &entry) {
+        return entry.statement == statement && entry.sql == sql;
+    });
+
+    if (cached == normalizedStatements.end()) {
+        string normalized = normalize(sql);
+        size_t shard = std::hash<string>()(normalized) % shards.size();
+
+        if (normalizedStatements.size() < MAX_NORMALIZED_STATEMENTS) {
+            cached = normalizedStatements.insert(normalizedStatements.end(), NormalizedStatement{statement, sql, std::move(normalized), shard});
+        } else {
+            cached = normalizedStatements.begin() + nextNormalizedStatement;
+            nextNormalizedStatement = (nextNormalizedStatement + 1) % MAX_NORMALIZED_STATEMENTS;
+            *cached = NormalizedStatement{statement, sql, std::move(normalized), shard};
+        }
+    }
+
+    string const &normalized = cached->normalized;
+    Shard &shard = shards[cached->shard];
+    bool slow = nanoseconds >= chrono::duration_cast<chrono::nanoseconds>(slowThreshold).count();
+    bool needsPlan = false;
+    string plan;
+
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        auto entry = shard.statistics.find(normalized);
+        if (entry == shard.statistics.end()) {
+            if (shard.statistics.size() >= MAX_STATEMENTS / shards.size()) {
+                return;
+            }
+            entry = shard.statistics.emplace(normalized, QueryStatistics()).first;
+            entry->second.statement = normalized;
+        }
+
+        QueryStatistics &current = entry->second;
+        current.count++;
+        current.totalNanoseconds += nanoseconds;
+        current.maxNanoseconds = std::max(current.maxNanoseconds, nanoseconds);
+
+        needsPlan = slow && current.plan.empty();
+        plan = current.plan;
+    }
+
+    if (!slow) {
+        return;
+    }
+
+    // explained once per statement shape, the first slow execution pays for it
+    if (needsPlan) {
+        char *expanded = sqlite3_expanded_sql(statement);
+        plan = explain(sqlite3_db_handle(statement), expanded ? expanded : sql);
+        sqlite3_free(expanded);
+
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.statistics[normalized].plan = plan;
+    }
+
+    // the normalized text keeps item titles out of the log
+    CROW_LOG_WARNING << "Slow query (" << nanoseconds / 1000000 << " ms): " << normalized << " | plan: " << plan;
+}
+
+std::string QueryProfiler::explain(sqlite3 *database, std::string const &sql) {
+    char const *databaseFile = sqlite3_db_filename(database, "main");
+    if (databaseFile == nullptr || *databaseFile == '\0') {
+        return "";
+    }
+
+    std::lock_guard<std::mutex> lock(explainMutex);
+
+    // a statement of the traced connection is still active, explaining on a
+    // connection of our own keeps out of its way
+    sqlite3 *&connection = explainConnections[databaseFile];
+    if (connection == nullptr) {
+        if (sqlite3_open_v2(databaseFile, &connection, SQLITE_OPEN_READONLY, nullptr) != SQLITE_OK) {
+            sqlite3_close(connection);
+            connection = nullptr;
+            return "";
+        }
+    }
+
+    string plan;
+    sqlite3_stmt *statement = nullptr;
+    string sqlExplain = "explain query plan " + sql;
+
+    if (sqlite3_prepare_v2(connection, sqlExplain.c_str(), -1, &statement, nullptr) == SQLITE_OK) {
+        while (sqlite3_step(statement) == SQLITE_ROW) {
+            char const *detail = reinterpret_cast<char const *>(sqlite3_column_text(statement, 3));
+            if (!plan.empty()) {
+                plan += "; ";
+            }
+            plan += detail ? detail : "";
+        }
+    }
+    sqlite3_finalize(statement);
+
+    return plan;
+}
+
+std::vector<QueryStatistics> QueryProfiler::getSlowestStatements(size_t limit) {
+    vector<QueryStatistics> slowest;
+    for (auto &shard : shards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        for (auto const &entry : shard.statistics)
+            slowest.push_back(entry.second);
+    }
+
+    std::sort(slowest.begin(), slowest.end(), [](QueryStatistics const &left, QueryStatistics const &right) {
+        return left.maxNanoseconds > right.maxNanoseconds;
+    });
+
+    if (slowest.size() > limit) {
+        slowest.resize(limit);
+    }
+
+    return slowest;
+}
+
+std::string QueryProfiler::normalize(std::string const &sql) {
+    string normalized;
+    normalized.reserve(sql.size());
+
+    auto isIdentifier = [](char c) {
+        return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+    };
+
+    size_t i = 0;
+    while (i < sql.size()) {
+        char c = sql[i];
+
+        if (c == '\'') {
+            // string literal, '' is an escaped quote inside it
+            i++;
+            while (i < sql.size()) {
+                if (sql[i] == '\'' && (i + 1 >= sql.size() || sql[i + 1] != '\'')) {
+                    break;
+                }
+                i += (sql[i] == '\'') ? 2 : 1;
+            }
+            normalized += '?';
+            i++;
+        } else if (std::isdigit(static_cast<unsigned char>(c)) && (normalized.empty() || !isIdentifier(normalized.back()))) {
+            while (i < sql.size() && (isIdentifier(sql[i]) || sql[i] == '.')) {
+                i++;
+            }
+            normalized += '?';
+        } else if (std::isspace(static_cast<unsigned char>(c))) {
+            while (i < sql.size() && std::isspace(static_cast<unsigned char>(sql[i]))) {
+                i++;
+            }
+            if (!normalized.empty()) {
+                normalized += ' ';
+            }
+        } else {
+            normalized += c;
+            i++;
+        }
+    }
+
+    while (!normalized.empty() && (normalized.back() == ' ' || normalized.back() == ';')) {
+        normalized.pop_back();
+    }
+
+    return normalized;
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "sqlite3.h"
+#include <chrono>
+#include <cstdint>
+#include <array>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Prog3 {
+namespace Repository {
+namespace SQLite {
+
+struct QueryStatistics {
+    std::string statement;
+    std::int64_t count = 0;
+    std::int64_t totalNanoseconds = 0;
+    std::int64_t maxNanoseconds = 0;
+    // query plan of the first execution that crossed the slow query threshold
+    std::string plan;
+};
+
+// Collects per-statement execution times through sqlite3_trace_v2. Statements
+// are grouped by their text with literals replaced by "?", so the string built
+// queries of BoardRepository fall into one entry per shape.
+class QueryProfiler {
+  private:
+    // statements of different shapes are counted under different locks, so
+    // boards running different queries do not wait for each other
+    struct Shard {
+        std::mutex mutex;
+        std::map<std::string, QueryStatistics> statistics;
+    };
+
+    std::chrono::milliseconds slowThreshold;
+    std::array<Shard, 16> shards;
+
+    // read only side connections per database file, only used for explain
+    std::mutex explainMutex;
+    std::map<std::string, sqlite3 *> explainConnections;
+
+    void record(sqlite3_stmt *statement, std::int64_t nanoseconds);
+    std::string explain(sqlite3 *database, std::string const &sql);
+
+    static int traceCallback(unsigned type, void *context, void *statement, void *elapsed);
+
+  public:
+    QueryProfiler(std::chrono::milliseconds givenSlowThreshold);
+    ~QueryProfiler();
+
+    void attach(sqlite3 *database);
+
+    // slowest first, by their longest single execution
+    std::vector<QueryStatistics> getSlowestStatements(size_t limit);
+
+    static std::string normalize(std::string const &sql);
+
+    // bounds memory if statements are built in ways normalize cannot fold
+    static inline size_t const MAX_STATEMENTS = 1000;
+    static inline size_t const MAX_RUNNING_STATEMENTS = 64;
+    static inline size_t const MAX_NORMALIZED_STATEMENTS = 64;
+};
+
+} // namespace SQLite
+} // namespace Repository
+} // namespace Prog3
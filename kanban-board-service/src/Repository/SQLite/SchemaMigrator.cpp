@@ -0,0 +1,209 @@
+#include "SchemaMigrator.hpp"
+#include "Core/Model/Timestamp.hpp"
+#include <iostream>
+
+using namespace Prog3::Repository::SQLite;
+using namespace Prog3::Core::Model;
+using namespace std;
+
+// user_version 0 is what sqlite reports for a fresh file as well as for
+// databases created before migrations existed. The first step therefore
+// only uses "if not exists" so it can be replayed on both.
+vector<SchemaMigration> const SchemaMigrator::migrations = {
+    {1, "create column and item tables",
+     "create table if not exists column("
+     "id integer not null primary key autoincrement,"
+     "name text not null,"
+     "position integer not null UNIQUE);"
+     "create table if not exists item("
+     "id integer not null primary key autoincrement,"
+     "title text not null,"
+     "date text not null,"
+     "position integer not null,"
+     "column_id integer not null,"
+     "unique (position, column_id),"
+     "foreign key (column_id) references column (id));"},
+    {2, "index items by column and position",
+     // serves "where column_id = ? order by position" without a scan or a temp b-tree;
+     // the unique (position, column_id) index has the wrong column order for that
+     "create index if not exists item_column_position on item (column_id, position);"},
+    {3, "record every mutation in change_log",
+     // the triggers also catch writes that bypass the service (e.g. test fixtures);
+     // an item moving between columns is logged as a delete in the old column
+     // followed by an insert into the new one, so per-column consumers stay simple
+     "create table if not exists change_log("
+     "seq integer not null primary key autoincrement,"
+     "entity text not null,"
+     "operation text not null,"
+     "entity_id integer not null,"
+     "column_id integer not null,"
+     "name text,"
+     "position integer,"
+     "date text);"
+     "create trigger if not exists column_insert_log after insert on column begin "
+     "insert into change_log (entity, operation, entity_id, column_id, name, position) "
+     "values ('column', 'insert', new.id, new.id, new.name, new.position); end;"
+     "create trigger if not exists column_update_log after update on column begin "
+     "insert into change_log (entity, operation, entity_id, column_id, name, position) "
+     "values ('column', 'update', new.id, new.id, new.name, new.position); end;"
+     "create trigger if not exists column_delete_log after delete on column begin "
+     "insert into change_log (entity, operation, entity_id, column_id) "
+     "values ('column', 'delete', old.id, old.id); end;"
+     "create trigger if not exists item_insert_log after insert on item begin "
+     "insert into change_log (entity, operation, entity_id, column_id, name, position, date) "
+     "values ('item', 'insert', new.id, new.column_id, new.title, new.position, new.date); end;"
+     "create trigger if not exists item_update_log after update on item "
+     "when old.column_id = new.column_id begin "
+     "insert into change_log (entity, operation, entity_id, column_id, name, position, date) "
+     "values ('item', 'update', new.id, new.column_id, new.title, new.position, new.date); end;"
+     "create trigger if not exists item_move_log after update on item "
+     "when old.column_id <> new.column_id begin "
+     "insert into change_log (entity, operation, entity_id, column_id) "
+     "values ('item', 'delete', old.id, old.column_id);"
+     "insert into change_log (entity, operation, entity_id, column_id, name, position, date) "
+     "values ('item', 'insert', new.id, new.column_id, new.title, new.position, new.date); end;"
+     "create trigger if not exists item_delete_log after delete on item begin "
+     "insert into change_log (entity, operation, entity_id, column_id) "
+     "values ('item', 'delete', old.id, old.column_id); end;"
+     // compaction: keep the newest 10000 entries, older clients get a full snapshot
+     "create trigger if not exists change_log_compact after insert on change_log begin "
+     "delete from change_log where seq <= new.seq - 10000; end;"},
+    {4, "full-text index over item titles",
+     // external content table: the index stores no copy of the titles, the
+     // triggers keep it in step with item; prefix indexes keep "abc*" cheap
+     "create virtual table if not exists item_fts using fts5("
+     "title, content = 'item', content_rowid = 'id', prefix = '2 3');"
+     "create trigger if not exists item_fts_insert after insert on item begin "
+     "insert into item_fts (rowid, title) values (new.id, new.title); end;"
+     "create trigger if not exists item_fts_delete after delete on item begin "
+     "insert into item_fts (item_fts, rowid, title) values ('delete', old.id, old.title); end;"
+     "create trigger if not exists item_fts_update after update of title on item begin "
+     "insert into item_fts (item_fts, rowid, title) values ('delete', old.id, old.title);"
+     "insert into item_fts (rowid, title) values (new.id, new.title); end;"
+     "insert into item_fts (item_fts) values ('rebuild');"},
+    {5, "track item modification time and add the item archive",
+     // modified is unix time set by the service; rows written behind its back
+     // keep 0 and are never archived
+     "alter table item add column modified integer not null default 0;"
+     "update item set modified = cast(strftime('%s', 'now') as integer);"
+     "create table if not exists item_archive("
+     "id integer not null primary key,"
+     "title text not null,"
+     "date text not null,"
+     "position integer not null,"
+     "column_id integer not null,"
+     "column_name text not null,"
+     "archived integer not null);"
+     "create index if not exists item_archive_archived on item_archive (archived, id);"},
+    {6, "store item times as unix time",
+     // created is written by the service next to the date text, rows written
+     // behind its back leave it null and keep answering with their date text.
+     // Only dates the service wrote itself are backfilled, see serviceTimestamp
+     "drop trigger if exists item_insert_log;"
+     "drop trigger if exists item_update_log;"
+     "drop trigger if exists item_move_log;"
+     "alter table item add column created integer;"
+     "update item set created = service_timestamp(date);"
+     "alter table item_archive add column created integer;"
+     "update item_archive set created = service_timestamp(date);"
+     "alter table change_log add column created integer;"
+     "update change_log set created = service_timestamp(date) where date is not null;"
+     "create trigger item_insert_log after insert on item begin "
+     "insert into change_log (entity, operation, entity_id, column_id, name, position, date, created) "
+     "values ('item', 'insert', new.id, new.column_id, new.title, new.position, new.date, new.created); end;"
+     "create trigger item_update_log after update on item "
+     "when old.column_id = new.column_id begin "
+     "insert into change_log (entity, operation, entity_id, column_id, name, position, date, created) "
+     "values ('item', 'update', new.id, new.column_id, new.title, new.position, new.date, new.created); end;"
+     "create trigger item_move_log after update on item "
+     "when old.column_id <> new.column_id begin "
+     "insert into change_log (entity, operation, entity_id, column_id) "
+     "values ('item', 'delete', old.id, old.column_id);"
+     "insert into change_log (entity, operation, entity_id, column_id, name, position, date, created) "
+     "values ('item', 'insert', new.id, new.column_id, new.title, new.position, new.date, new.created); end;"},
+};
+
+// service_timestamp(date): the unix time of a date in exactly the form the
+// service writes, null for anything else. A date from another tool stays the
+// text it was, so the api answers it unchanged
+static void serviceTimestamp(sqlite3_context *context, int, sqlite3_value **values) {
+    auto date = reinterpret_cast<char const *>(sqlite3_value_text(values[0]));
+    std::int64_t timestamp = 0;
+
+    if (date && parseTimestamp(date, timestamp) && formatTimestamp(timestamp) == date) {
+        sqlite3_result_int64(context, timestamp);
+    } else {
+        sqlite3_result_null(context);
+    }
+}
+
+SchemaMigrator::SchemaMigrator(sqlite3 *givenDatabase) : database(givenDatabase) {
+}
+
+int SchemaMigrator::getLatestVersion() {
+    return migrations.empty() ? 0 : migrations.back().version;
+}
+
+int SchemaMigrator::getCurrentVersion() {
+    sqlite3_stmt *statement = nullptr;
+    int version = 0;
+
+    if (sqlite3_prepare_v2(database, "pragma user_version", -1, &statement, nullptr) == SQLITE_OK) {
+        if (sqlite3_step(statement) == SQLITE_ROW) {
+            version = sqlite3_column_int(statement, 0);
+        }
+    }
+    sqlite3_finalize(statement);
+
+    return version;
+}
+
+int SchemaMigrator::migrate() {
+    int currentVersion = getCurrentVersion();
+
+    if (currentVersion > getLatestVersion()) {
+        cout << "Database schema version " << currentVersion << " is newer than this service ("
+             << getLatestVersion() << "), skipping migrations" << endl;
+        return currentVersion;
+    }
+
+    sqlite3_create_function(database, "service_timestamp", 1, SQLITE_UTF8 | SQLITE_DETERMINISTIC, nullptr,
+                            serviceTimestamp, nullptr, nullptr);
+
+    for (auto const &migration : migrations) {
+        if (migration.version <= currentVersion) {
+            continue;
+        }
+
+        if (!apply(migration)) {
+            break;
+        }
+        currentVersion = migration.version;
+    }
+
+    return currentVersion;
+}
+
+bool SchemaMigrator::apply(SchemaMigration const &migration) {
+    char *errorMessage = nullptr;
+
+    // the step and its version bump commit together, a failed step leaves the
+    // database at the previous version and is retried on the next start
+    string sqlMigration = "begin immediate;" +
+                          migration.statements +
+                          "pragma user_version = " + to_string(migration.version) + ";" +
+                          "commit;";
+
+    int result = sqlite3_exec(database, sqlMigration.c_str(), NULL, 0, &errorMessage);
+
+    if (result != SQLITE_OK) {
+        cout << "Migration " << migration.version << " (" << migration.description
+             << ") failed: " << errorMessage << endl;
+        sqlite3_free(errorMessage);
+        sqlite3_exec(database, "rollback;", NULL, 0, nullptr);
+        return false;
+    }
+
+    cout << "Migrated database schema to version " << migration.version << " (" << migration.description << ")" << endl;
+    return true;
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "sqlite3.h"
+#include <string>
+#include <vector>
+
+namespace Prog3 {
+namespace Repository {
+namespace SQLite {
+
+// One forward-only schema step. Once released a migration must never be
+// edited, changes to the schema always go into a new migration.
+struct SchemaMigration {
+    int version;
+    std::string description;
+    std::string statements;
+};
+
+class SchemaMigrator {
+  private:
+    sqlite3 *database;
+
+    static std::vector<SchemaMigration> const migrations;
+
+    bool apply(SchemaMigration const &migration);
+
+  public:
+    SchemaMigrator(sqlite3 *givenDatabase);
+    ~SchemaMigrator() {}
+
+    int getCurrentVersion();
+    int migrate();
+
+    static int getLatestVersion();
+};
+
+} // namespace SQLite
+} // namespace Repository
+} // namespace Prog3
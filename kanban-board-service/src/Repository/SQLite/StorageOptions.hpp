@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace Prog3 {
+namespace Repository {
+namespace SQLite {
+
+// Page cache, memory mapping and durability of every board handle, applied
+// when a board is opened. The values are passed to the pragmas unchanged: a
+// negative cacheSize is a limit in KiB, a positive one a number of pages.
+struct StorageOptions {
+    std::int64_t cacheSize = -2000;
+    // bytes of the database file read through mmap instead of the page cache, 0 is off
+    std::int64_t mmapSize = 0;
+    // off, normal, full or extra. in wal mode normal only syncs at checkpoints,
+    // a power loss may then lose the last commits but never corrupts the board
+    std::string synchronous = "full";
+};
+
+} // namespace SQLite
+} // namespace Repository
+} // namespace Prog3
@@ -0,0 +1,141 @@
+#include "StorageScheduler.hpp"
+#include "Core/Exception/DeadlineExceededException.hpp"
+#include <algorithm>
+
+using namespace Prog3::Repository::SQLite;
+using namespace Prog3::Core;
+using namespace Prog3::Core::Metrics;
+
+StorageScheduler::StorageScheduler() : metrics(nullptr) {
+}
+
+void StorageScheduler::configure(SchedulingOptions givenOptions, MetricsRegistry *givenMetrics) {
+    std::lock_guard<std::mutex> lock(schedulerMutex);
+
+    options = givenOptions;
+    metrics = givenMetrics;
+}
+
+int StorageScheduler::getWaiting() {
+    std::lock_guard<std::mutex> lock(schedulerMutex);
+
+    int count = 0;
+    for (auto const &queue : waiting)
+        count += static_cast<int>(queue.size());
+
+    return count;
+}
+
+void StorageScheduler::acquire() {
+    RequestContext const &context = RequestContext::current();
+    RequestPriority priority = context.getPriority();
+    auto started = std::chrono::steady_clock::now();
+
+    std::unique_lock<std::mutex> lock(schedulerMutex);
+
+    if (busy && owner == std::this_thread::get_id()) {
+        depth++;
+        return;
+    }
+
+    bool nobodyWaiting = std::all_of(waiting.begin(), waiting.end(), [](auto const &queue) { return queue.empty(); });
+
+    if (!busy && nobodyWaiting) {
+        busy = true;
+        interactiveStreak = (priority == RequestPriority::Interactive) ? interactiveStreak + 1 : 0;
+    } else {
+        std::uint64_t ticket = ++nextTicket;
+        std::deque<Waiter> &queue = waiting[static_cast<int>(priority)];
+        queue.push_back(Waiter{ticket, started});
+
+        auto granted = [this, ticket]() { return grantedTicket == ticket; };
+
+        if (context.getDeadline()) {
+            if (!turnChanged.wait_until(lock, *context.getDeadline(), granted)) {
+                queue.erase(std::find_if(queue.begin(), queue.end(), [ticket](Waiter const &waiter) { return waiter.ticket == ticket; }));
+                throw Prog3::Core::Exception::DeadlineExceededException();
+            }
+        } else {
+            turnChanged.wait(lock, granted);
+        }
+    }
+
+    owner = std::this_thread::get_id();
+    depth = 1;
+    MetricsRegistry *currentMetrics = metrics;
+    lock.unlock();
+
+    if (currentMetrics) {
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+        currentMetrics->observe(MetricsRegistry::withLabel("kanban_storage_queue_delay_seconds", "class", getClassName(priority)), seconds);
+    }
+}
+
+void StorageScheduler::release() {
+    std::lock_guard<std::mutex> lock(schedulerMutex);
+
+    if (--depth > 0) {
+        return;
+    }
+
+    busy = false;
+    owner = std::thread::id();
+    grantNext();
+}
+
+void StorageScheduler::grantNext() {
+    std::deque<Waiter> &interactive = waiting[static_cast<int>(RequestPriority::Interactive)];
+    std::deque<Waiter> &writes = waiting[static_cast<int>(RequestPriority::Write)];
+    std::deque<Waiter> &bulk = waiting[static_cast<int>(RequestPriority::Bulk)];
+
+    bool bulkPromoted = !bulk.empty() && std::chrono::steady_clock::now() - bulk.front().enqueued >= options.bulkPromotionDelay;
+
+    // whoever competes with the interactive reads for the write share,
+    // writes and promoted bulk work in the order they arrived
+    std::deque<Waiter> *writer = nullptr;
+    if (!writes.empty() && bulkPromoted) {
+        writer = (bulk.front().enqueued < writes.front().enqueued) ? &bulk : &writes;
+    } else if (!writes.empty()) {
+        writer = &writes;
+    } else if (bulkPromoted) {
+        writer = &bulk;
+    }
+
+    std::deque<Waiter> *next = nullptr;
+    if (!interactive.empty() && (writer == nullptr || interactiveStreak < options.interactivePerWrite)) {
+        next = &interactive;
+        interactiveStreak++;
+    } else if (writer) {
+        next = writer;
+        interactiveStreak = 0;
+    } else if (!bulk.empty()) {
+        next = &bulk;
+        interactiveStreak = 0;
+    } else {
+        return;
+    }
+
+    grantedTicket = next->front().ticket;
+    next->pop_front();
+    busy = true;
+    turnChanged.notify_all();
+}
+
+char const *StorageScheduler::getClassName(RequestPriority priority) {
+    switch (priority) {
+    case RequestPriority::Interactive:
+        return "interactive";
+    case RequestPriority::Write:
+        return "write";
+    default:
+        return "bulk";
+    }
+}
+
+StorageScheduler::Turn::Turn(StorageScheduler &givenScheduler) : scheduler(givenScheduler) {
+    scheduler.acquire();
+}
+
+StorageScheduler::Turn::~Turn() {
+    scheduler.release();
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "Core/Metrics/MetricsRegistry.hpp"
+#include "Core/RequestContext.hpp"
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace Prog3 {
+namespace Repository {
+namespace SQLite {
+
+struct SchedulingOptions {
+    // turns interactive requests get in a row while writes are waiting
+    int interactivePerWrite = 4;
+    // bulk work waiting this long is served like a write
+    std::chrono::milliseconds bulkPromotionDelay{1000};
+};
+
+// Hands out the turns on one board's database handle. The handle serializes
+// statements anyway, the scheduler only decides who is next: interactive reads
+// first, writes at least every interactivePerWrite turns, bulk work when
+// nothing else is waiting or once it has waited too long. The priority and
+// deadline come from the RequestContext of the calling thread. A thread that
+// already holds the turn gets it again, repository methods may call each other.
+class StorageScheduler {
+  private:
+    struct Waiter {
+        std::uint64_t ticket;
+        std::chrono::steady_clock::time_point enqueued;
+    };
+
+    SchedulingOptions options;
+    Prog3::Core::Metrics::MetricsRegistry *metrics;
+
+    std::mutex schedulerMutex;
+    std::condition_variable turnChanged;
+    std::array<std::deque<Waiter>, 3> waiting;
+    std::uint64_t nextTicket = 0;
+    std::uint64_t grantedTicket = 0;
+    bool busy = false;
+    std::thread::id owner;
+    int depth = 0;
+    int interactiveStreak = 0;
+
+    void acquire();
+    void release();
+    void grantNext();
+
+  public:
+    // holds the turn for its lifetime
+    class Turn {
+      private:
+        StorageScheduler &scheduler;
+
+      public:
+        Turn(StorageScheduler &givenScheduler);
+        ~Turn();
+
+        Turn(Turn const &) = delete;
+        Turn &operator=(Turn const &) = delete;
+    };
+
+    StorageScheduler();
+    ~StorageScheduler() {}
+
+    void configure(SchedulingOptions givenOptions, Prog3::Core::Metrics::MetricsRegistry *givenMetrics);
+    // requests queued for a turn, not counting the one holding it
+    int getWaiting();
+
+    static char const *getClassName(Prog3::Core::RequestPriority priority);
+};
+
+} // namespace SQLite
+} // namespace Repository
+} // namespace Prog3
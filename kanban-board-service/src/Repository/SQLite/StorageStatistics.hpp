@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Prog3 {
+namespace Repository {
+namespace SQLite {
+
+// sqlite3_db_status counters and file sizes of one board handle.
+// Hits, misses, writes and spills count since the board was opened.
+struct StorageStatistics {
+    std::int64_t databaseBytes = 0;
+    std::int64_t walBytes = 0;
+    std::int64_t pageSize = 0;
+    std::int64_t pageCount = 0;
+    std::int64_t freelistCount = 0;
+
+    std::int64_t cacheSize = 0;
+    std::int64_t mmapSize = 0;
+
+    std::int64_t cacheUsedBytes = 0;
+    std::int64_t cacheHits = 0;
+    std::int64_t cacheMisses = 0;
+    std::int64_t cacheWrites = 0;
+    std::int64_t cacheSpills = 0;
+
+    std::int64_t schemaBytes = 0;
+    std::int64_t statementBytes = 0;
+    std::int64_t lookasideUsed = 0;
+    std::int64_t lookasideHighwater = 0;
+};
+
+} // namespace SQLite
+} // namespace Repository
+} // namespace Prog3
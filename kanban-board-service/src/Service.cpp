@@ -1,21 +1,243 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
 #include <iostream>
+#include <memory>
+#include <sstream>
 #include <string>
+#include <thread>
+#include <vector>
 
+#include "Api/AdminEndpoint.hpp"
 #include "Api/Endpoint.hpp"
 #include "Api/Parser/JsonParser.hpp"
-#include "Core/BoardManager.hpp"
-#include "Repository/SQLite/BoardRepository.hpp"
+#include "Api/UnixSocketServer.hpp"
+#include "Core/Admission/AdmissionController.hpp"
+#include "Core/BoardDirectory.hpp"
+#include "Core/Configuration.hpp"
+#include "Core/Metrics/MetricsRegistry.hpp"
+#include "Core/PeriodicTask.hpp"
+#include "Repository/SQLite/BackupService.hpp"
+#include "Repository/SQLite/BoardRepositoryPool.hpp"
+#include "Repository/SQLite/CheckpointScheduler.hpp"
+#include "Repository/SQLite/QueryProfiler.hpp"
 #include "crow.h"
 
-int main() {
+namespace {
+
+std::vector<std::string> splitList(std::string const &list) {
+    std::vector<std::string> entries;
+    std::istringstream stream(list);
+    std::string entry;
+
+    while (std::getline(stream, entry, ',')) {
+        if (!entry.empty())
+            entries.push_back(entry);
+    }
+
+    return entries;
+}
+
+unsigned getThreads(long configured) {
+    return configured > 0 ? static_cast<unsigned>(configured) : std::max(1u, std::thread::hardware_concurrency());
+}
+
+crow::LogLevel getLogLevel(std::string const &name) {
+    if (name == "debug")
+        return crow::LogLevel::Debug;
+    if (name == "warning")
+        return crow::LogLevel::Warning;
+    if (name == "error")
+        return crow::LogLevel::Error;
+    if (name == "critical")
+        return crow::LogLevel::Critical;
+    return crow::LogLevel::Info;
+}
+
+} // namespace
+
+// settings come from the file given as --config <file> or KANBAN_CONFIG, environment
+// variables override it. all of them are listed in docs/README_BACKEND.md
+int main(int argc, char **argv) {
+    Prog3::Core::Configuration configuration;
+    char const *configurationFile = std::getenv("KANBAN_CONFIG");
+    for (int i = 1; i + 1 < argc; i++) {
+        if (std::string(argv[i]) == "--config")
+            configurationFile = argv[i + 1];
+    }
+    if (configurationFile && !configuration.load(configurationFile)) {
+        return 1;
+    }
+
+    crow::logger::setLogLevel(getLogLevel(configuration.getChoice("server.logLevel", "KANBAN_LOG_LEVEL",
+                                                                  {"debug", "info", "warning", "error", "critical"}, "info")));
+    if (!configuration.getFile().empty()) {
+        CROW_LOG_INFO << "Configuration from " << configuration.getFile();
+    }
+
     crow::SimpleApp crowApplication;
-    Prog3::Repository::SQLite::BoardRepository sqlRepository;
+    Prog3::Core::Metrics::MetricsRegistry metrics;
+    // statement timings for /api/admin/queries, statements above the threshold are logged with their plan.
+    // declared before the pool, the board handles report to it until they are closed
+    Prog3::Repository::SQLite::QueryProfiler queryProfiler(std::chrono::milliseconds(configuration.getLong("storage.slowQueryMs", "KANBAN_SLOW_QUERY_MS", 50L, 0L)));
+    // boards other than the default one are sharded into files below the shard directory
+    std::string databaseFile = configuration.getString("storage.databaseFile", "KANBAN_DATABASE_FILE", Prog3::Repository::SQLite::BoardRepository::databaseFile);
+    Prog3::Repository::SQLite::BoardRepositoryPool repositoryPool(
+        databaseFile, configuration.getString("storage.shardDirectory", "KANBAN_SHARD_DIRECTORY",
+                                              Prog3::Repository::SQLite::BoardRepositoryPool::getDefaultShardDirectory(databaseFile)));
     Prog3::Api::Parser::JsonParser jsonParser;
 
-    Prog3::Core::BoardManager boardManager(jsonParser, sqlRepository);
-    Prog3::Api::Endpoint endpoint(crowApplication, boardManager);
+    // e.g. KANBAN_SQLITE_CACHE_SIZE=-65536 gives every board a 64 MiB page cache
+    Prog3::Repository::SQLite::StorageOptions storageOptions;
+    storageOptions.cacheSize = configuration.getLong("storage.cacheSize", "KANBAN_SQLITE_CACHE_SIZE", static_cast<long>(storageOptions.cacheSize));
+    storageOptions.mmapSize = configuration.getLong("storage.mmapSize", "KANBAN_SQLITE_MMAP_SIZE", static_cast<long>(storageOptions.mmapSize));
+    storageOptions.synchronous = configuration.getChoice("storage.synchronous", "KANBAN_SQLITE_SYNCHRONOUS", {"off", "normal", "full", "extra"},
+                                                         storageOptions.synchronous);
+    repositoryPool.setStorageOptions(storageOptions);
+
+    // interactive reads go first, writes get every few turns, X-Request-Priority: bulk comes last
+    Prog3::Repository::SQLite::SchedulingOptions schedulingOptions;
+    schedulingOptions.interactivePerWrite = configuration.getLong("scheduling.interactivePerWrite", "KANBAN_INTERACTIVE_PER_WRITE", static_cast<long>(schedulingOptions.interactivePerWrite));
+    schedulingOptions.bulkPromotionDelay = std::chrono::milliseconds(configuration.getLong("scheduling.bulkPromotionMs", "KANBAN_BULK_PROMOTION_MS", static_cast<long>(schedulingOptions.bulkPromotionDelay.count()), 0L));
+    repositoryPool.setScheduling(schedulingOptions, metrics);
+
+    if (configuration.getLong("storage.queryProfiling", "KANBAN_QUERY_PROFILING", 1L) != 0) {
+        repositoryPool.setQueryProfiler(queryProfiler);
+    }
+
+    // boards are opened on first use and stay open, every one of them holds a file descriptor
+    repositoryPool.setMaxOpenBoards(std::max(1L, configuration.getLong("storage.maxOpenBoards", "KANBAN_MAX_OPEN_BOARDS",
+                                                                       static_cast<long>(Prog3::Repository::SQLite::BoardRepositoryPool::DEFAULT_MAX_OPEN_BOARDS))));
+
+    Prog3::Core::BoardDirectory boardDirectory(jsonParser, [&repositoryPool](int boardId, bool create) -> Prog3::Core::BoardManager::RepositoryType * {
+        return create ? &repositoryPool.createRepository(boardId) : repositoryPool.getRepository(boardId);
+    });
+
+    // reads are answered from memory without looking at the database. writes made behind the
+    // service's back, e.g. by scripts or the api tests, are looked for this often on every open board
+    long versionCheckMs = configuration.getLong("storage.versionCheckMs", "KANBAN_VERSION_CHECK_MS", 20L, 1L);
+    Prog3::Core::PeriodicTask outsideWritesTask("outside writes", std::chrono::milliseconds(versionCheckMs), [&boardDirectory]() {
+        boardDirectory.forEachBoardManager([](int, Prog3::Core::BoardManager &boardManager) {
+            boardManager.pickUpOutsideWrites();
+        });
+    });
+
+    // the handlers run their storage work on these threads, there is no separate storage pool.
+    // how many of them may be on the boards at once is up to the admission limits below. 0 is one per core
+    long port = configuration.getLong("server.port", "KANBAN_PORT", 8080L);
+    unsigned threads = getThreads(configuration.getLong("server.threads", "KANBAN_THREADS", 0L));
+
+    // e.g. KANBAN_UNIX_SOCKET=/run/kanban/service.sock for a proxy on the same host,
+    // KANBAN_PORT=0 leaves the unix socket as the only listener
+    Prog3::Api::UnixSocketOptions unixSocketOptions;
+    unixSocketOptions.path = configuration.getString("server.unixSocket", "KANBAN_UNIX_SOCKET", "");
+    unixSocketOptions.threads = getThreads(configuration.getLong("server.unixSocketThreads", "KANBAN_UNIX_SOCKET_THREADS", 0L));
+    unixSocketOptions.mode = configuration.getOctal("server.unixSocketMode", "KANBAN_UNIX_SOCKET_MODE", unixSocketOptions.mode);
+#ifndef KANBAN_HAS_UNIX_SOCKET
+    if (!unixSocketOptions.path.empty()) {
+        CROW_LOG_WARNING << "Unix domain sockets are not supported on this platform, " << unixSocketOptions.path << " is not served";
+        unixSocketOptions.path.clear();
+    }
+#endif
+
+    // reads and writes are shed separately, a flood of writes leaves room for reads. a handler holds
+    // its thread until it is done, so more requests than threads are never in flight: by default
+    // reads may take every thread and writes half of them, the limits only go lower from there
+    long workers = (port != 0 ? threads : 0) + (unixSocketOptions.path.empty() ? 0 : unixSocketOptions.threads);
+    Prog3::Core::Admission::AdmissionOptions admissionOptions;
+    admissionOptions.maxReads = configuration.getLong("admission.maxReads", "KANBAN_ADMISSION_MAX_READS", workers);
+    admissionOptions.maxWrites = configuration.getLong("admission.maxWrites", "KANBAN_ADMISSION_MAX_WRITES", std::max(1L, workers / 2));
+    admissionOptions.targetLatency = std::chrono::milliseconds(configuration.getLong("admission.targetLatencyMs", "KANBAN_ADMISSION_TARGET_LATENCY_MS", static_cast<long>(admissionOptions.targetLatency.count()), 1L));
+
+    Prog3::Core::Admission::AdmissionController admissionController(metrics, admissionOptions);
+    // requests without an X-Request-Timeout-Ms header get these deadlines
+    Prog3::Core::DeadlineOptions deadlineOptions;
+    deadlineOptions.readTimeout = std::chrono::milliseconds(configuration.getLong("timeouts.readMs", "KANBAN_READ_TIMEOUT_MS", static_cast<long>(deadlineOptions.readTimeout.count()), 1L));
+    deadlineOptions.writeTimeout = std::chrono::milliseconds(configuration.getLong("timeouts.writeMs", "KANBAN_WRITE_TIMEOUT_MS", static_cast<long>(deadlineOptions.writeTimeout.count()), 1L));
+    deadlineOptions.maxTimeout = std::chrono::milliseconds(configuration.getLong("timeouts.maxMs", "KANBAN_MAX_TIMEOUT_MS", static_cast<long>(deadlineOptions.maxTimeout.count()), 1L));
+
+    Prog3::Api::Endpoint endpoint(crowApplication, boardDirectory, admissionController, deadlineOptions);
+
+    // e.g. KANBAN_ARCHIVE_COLUMNS=finished,done archives their items after 30 days without changes
+    Prog3::Repository::SQLite::ArchivePolicy archivePolicy;
+    archivePolicy.columnNames = splitList(configuration.getString("archive.columns", "KANBAN_ARCHIVE_COLUMNS", ""));
+    archivePolicy.maxAge = std::chrono::seconds(configuration.getLong("archive.maxAgeSeconds", "KANBAN_ARCHIVE_MAX_AGE_SECONDS", static_cast<long>(archivePolicy.maxAge.count()), 0L));
+
+    Prog3::Core::PeriodicTask archiveTask("archive", std::chrono::seconds(configuration.getLong("archive.intervalSeconds", "KANBAN_ARCHIVE_INTERVAL_SECONDS", 3600L, 1L)), [&repositoryPool, &archivePolicy, &boardDirectory]() {
+        repositoryPool.forEachRepository([&archivePolicy, &boardDirectory](int boardId, Prog3::Repository::SQLite::BoardRepository &repository) {
+            int archived = repository.archiveItems(archivePolicy);
+            if (archived > 0) {
+                CROW_LOG_INFO << "Archived " << archived << " items of board " << boardId;
+
+                // the items leave the board's snapshot now, not with the next look for outside writes
+                if (auto boardManager = boardDirectory.getBoardManager(boardId)) {
+                    boardManager->pickUpOutsideWrites();
+                }
+            }
+        });
+    });
+
+    Prog3::Repository::SQLite::BackupOptions backupOptions;
+    backupOptions.directory = configuration.getString("backup.directory", "KANBAN_BACKUP_DIRECTORY", "");
+    // a step of 0 pages would never finish, and keeping 0 backups would delete the one just written
+    backupOptions.pagesPerStep = std::max(1L, configuration.getLong("backup.pagesPerStep", "KANBAN_BACKUP_PAGES_PER_STEP", static_cast<long>(backupOptions.pagesPerStep)));
+    backupOptions.stepPause = std::chrono::milliseconds(configuration.getLong("backup.stepPauseMs", "KANBAN_BACKUP_STEP_PAUSE_MS", static_cast<long>(backupOptions.stepPause.count()), 0L));
+    backupOptions.keep = std::max(1L, configuration.getLong("backup.keep", "KANBAN_BACKUP_KEEP", static_cast<long>(backupOptions.keep)));
+
+    Prog3::Repository::SQLite::BackupService backupService(repositoryPool, metrics, backupOptions);
+    Prog3::Api::AdminEndpoint adminEndpoint(crowApplication, metrics, backupService, queryProfiler, repositoryPool);
+
+    // scheduled backups are off unless an interval is configured
+    std::unique_ptr<Prog3::Core::PeriodicTask> backupTask;
+    long backupInterval = configuration.getLong("backup.intervalSeconds", "KANBAN_BACKUP_INTERVAL_SECONDS", 0L, 0L);
+    if (backupInterval > 0) {
+        backupTask = std::make_unique<Prog3::Core::PeriodicTask>("backup", std::chrono::seconds(backupInterval), [&backupService]() {
+            backupService.run();
+        });
+    }
+
+    Prog3::Repository::SQLite::CheckpointOptions checkpointOptions;
+    checkpointOptions.interval = std::chrono::milliseconds(configuration.getLong("checkpoint.intervalMs", "KANBAN_CHECKPOINT_INTERVAL_MS", static_cast<long>(checkpointOptions.interval.count()), 1L));
+    checkpointOptions.walLimitBytes = configuration.getLong("checkpoint.walLimitBytes", "KANBAN_WAL_LIMIT_BYTES", static_cast<long>(checkpointOptions.walLimitBytes));
+
+    Prog3::Repository::SQLite::CheckpointScheduler checkpointScheduler(repositoryPool, metrics, checkpointOptions);
+    Prog3::Core::PeriodicTask checkpointTask("checkpoint", checkpointOptions.interval, [&checkpointScheduler]() {
+        checkpointScheduler.run();
+    });
+
+#ifdef KANBAN_HAS_UNIX_SOCKET
+    if (!unixSocketOptions.path.empty()) {
+        Prog3::Api::UnixSocketServer unixSocketServer(crowApplication, unixSocketOptions);
+
+        if (port == 0) {
+            crowApplication.validate();
+            return unixSocketServer.run() ? 0 : 1;
+        }
+
+        // crow validates the router once, in run(), and the unix socket must not use it before.
+        // the first tick comes after that, on crow's accept thread. a proxy in front of the
+        // socket would fail every request, so the service does not go on with tcp alone
+        bool unixSocketStarted = false;
+        bool unixSocketFailed = false;
+        crowApplication.port(port)
+            .concurrency(threads)
+            .tick(std::chrono::milliseconds(100), [&crowApplication, &unixSocketServer, &unixSocketStarted, &unixSocketFailed]() {
+                if (!unixSocketStarted) {
+                    unixSocketStarted = true;
+                    unixSocketFailed = !unixSocketServer.start();
+                    if (unixSocketFailed) {
+                        crowApplication.stop();
+                    }
+                }
+            })
+            .run();
+        unixSocketServer.stop();
+
+        return unixSocketFailed ? 1 : 0;
+    }
+#endif
 
-    crowApplication.port(8080)
-        .multithreaded()
+    crowApplication.port(port)
+        .concurrency(threads)
         .run();
 }
@@ -0,0 +1,106 @@
+#include "Api/Endpoint.hpp"
+#include "Api/Parser/JsonParser.hpp"
+#include "Api/RequestDriver.hpp"
+#include "Core/Admission/AdmissionController.hpp"
+#include "Core/BoardDirectory.hpp"
+#include "Core/Metrics/MetricsRegistry.hpp"
+#include "Repository/SQLite/BoardRepository.hpp"
+#include "rapidjson/document.h"
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <unistd.h>
+
+using namespace Prog3::Api;
+using namespace Prog3::Api::Parser;
+using namespace Prog3::Core;
+using namespace Prog3::Repository::SQLite;
+
+namespace {
+
+int failures = 0;
+
+void expectResponse(char const *name, crow::response const &res, int expectedCode, std::string const &expectedBody) {
+    if (res.code == expectedCode && res.body == expectedBody) {
+        std::printf("ok      %s\n", name);
+        return;
+    }
+
+    std::printf("FAILED  %s\n        expected: %d %s\n        got:      %d %s\n", name, expectedCode, expectedBody.c_str(),
+                res.code, res.body.c_str());
+    failures++;
+}
+
+// the id the service gave a posted column or item, -1 if the body has none
+std::int64_t getId(crow::response const &res) {
+    rapidjson::Document document;
+    document.Parse(res.body.c_str());
+
+    return document.IsObject() && document.HasMember("id") ? document["id"].GetInt64() : -1;
+}
+
+// the timestamp is the time of the post, the rest of an item is known up front
+std::string getTimestamp(crow::response const &res) {
+    rapidjson::Document document;
+    document.Parse(res.body.c_str());
+
+    return document.IsObject() && document.HasMember("timestamp") ? document["timestamp"].GetString() : "";
+}
+
+} // namespace
+
+// Drives the board routes through RequestDriver, the way HotPathBenchmark
+// times them, and checks status and body of every answer. The board lives in
+// a database of its own in the temp directory.
+int main() {
+    std::filesystem::path directory = std::filesystem::temp_directory_path() / ("kanban-request-driver-" + std::to_string(getpid()));
+    std::filesystem::remove_all(directory);
+
+    {
+        BoardRepository repository((directory / "kanban-board.db").string(), "Test Board");
+        JsonParser parser;
+        crow::SimpleApp app;
+        Metrics::MetricsRegistry metrics;
+        BoardDirectory boardDirectory(parser, [&repository](int, bool) -> BoardManager::RepositoryType * { return &repository; });
+        Admission::AdmissionController admissionController(metrics, Admission::AdmissionOptions());
+        Endpoint endpoint(app, boardDirectory, admissionController, DeadlineOptions());
+        RequestDriver driver(app);
+
+        expectResponse("GET an empty board", driver.get("/api/board"), 200, R"({"title":"Test Board","columns":[]})");
+
+        crow::response res = driver.post("/api/board/columns", R"({"name":"todo","position":1})");
+        std::string columnId = std::to_string(getId(res));
+        std::string column = "/api/board/columns/" + columnId;
+        expectResponse("POST a column", res, 201, R"({"id":)" + columnId + R"(,"name":"todo","position":1,"items":[]})");
+
+        res = driver.post(column + "/items", R"({"title":"write tests","position":1})");
+        std::string itemId = std::to_string(getId(res));
+        std::string item = column + "/items/" + itemId;
+        std::string timestamp = getTimestamp(res);
+        expectResponse("POST an item", res, 201,
+                       R"({"id":)" + itemId + R"(,"title":"write tests","position":1,"timestamp":")" + timestamp + R"("})");
+
+        expectResponse("GET the item", driver.get(item), 200,
+                       R"({"id":)" + itemId + R"(,"title":"write tests","position":1,"timestamp":")" + timestamp + R"("})");
+
+        expectResponse("PUT the item", driver.put(item, R"({"title":"run tests","position":2})"), 200,
+                       R"({"id":)" + itemId + R"(,"title":"run tests","position":2,"timestamp":")" + timestamp + R"("})");
+
+        expectResponse("GET the column with the changed item", driver.get(column), 200,
+                       R"({"id":)" + columnId + R"(,"name":"todo","position":1,"items":[{"id":)" +
+                           itemId + R"(,"title":"run tests","position":2,"timestamp":")" + timestamp + R"("}]})");
+
+        expectResponse("DELETE the item", driver.remove(item), 200, "");
+        // the board api answers items and columns that do not exist with an empty object
+        expectResponse("GET the deleted item", driver.get(item), 200, "{}");
+
+        expectResponse("DELETE the column", driver.remove(column), 200, "{}");
+        expectResponse("GET the board without it", driver.get("/api/board"), 200, R"({"title":"Test Board","columns":[]})");
+
+        expectResponse("GET a route that does not exist", driver.get("/api/nothing"), 404, "");
+    }
+
+    std::filesystem::remove_all(directory);
+
+    return failures == 0 ? 0 : 1;
+}
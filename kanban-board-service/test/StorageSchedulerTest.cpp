@@ -0,0 +1,126 @@
+#include "Core/RequestContext.hpp"
+#include "Repository/SQLite/StorageScheduler.hpp"
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Prog3::Core;
+using namespace Prog3::Repository::SQLite;
+
+namespace {
+
+struct Request {
+    std::string name;
+    RequestPriority priority;
+};
+
+int failures = 0;
+
+std::string join(std::vector<std::string> const &names) {
+    std::string joined;
+    for (auto const &name : names)
+        joined += (joined.empty() ? "" : " ") + name;
+
+    return joined;
+}
+
+// The test thread holds the turn while the requests queue up, one after the
+// other in the given order, and lets go holdAfterQueued later. Returns the
+// order in which the requests got their turns.
+std::vector<std::string> runQueued(SchedulingOptions const &options, std::vector<Request> const &requests,
+                                   std::chrono::milliseconds holdAfterQueued) {
+    StorageScheduler scheduler;
+    scheduler.configure(options, nullptr);
+
+    std::mutex orderMutex;
+    std::vector<std::string> order;
+    std::vector<std::thread> threads;
+
+    {
+        RequestContext::Scope context(std::nullopt, RequestPriority::Interactive);
+        StorageScheduler::Turn holder(scheduler);
+
+        for (std::size_t i = 0; i < requests.size(); i++) {
+            threads.emplace_back([&scheduler, &orderMutex, &order, request = requests[i]]() {
+                RequestContext::Scope context(std::nullopt, request.priority);
+                StorageScheduler::Turn turn(scheduler);
+
+                std::lock_guard<std::mutex> lock(orderMutex);
+                order.push_back(request.name);
+            });
+
+            // the next request is only started once this one is queued
+            while (scheduler.getWaiting() < static_cast<int>(i + 1))
+                std::this_thread::yield();
+        }
+
+        std::this_thread::sleep_for(holdAfterQueued);
+    }
+
+    for (auto &thread : threads)
+        thread.join();
+
+    return order;
+}
+
+void expectOrder(char const *name, std::vector<std::string> const &order, std::string const &expected) {
+    if (join(order) == expected) {
+        std::printf("ok      %s\n", name);
+        return;
+    }
+
+    std::printf("FAILED  %s\n        expected: %s\n        got:      %s\n", name, expected.c_str(), join(order).c_str());
+    failures++;
+}
+
+Request interactive(std::string name) {
+    return Request{name, RequestPriority::Interactive};
+}
+
+Request write(std::string name) {
+    return Request{name, RequestPriority::Write};
+}
+
+Request bulk(std::string name) {
+    return Request{name, RequestPriority::Bulk};
+}
+
+} // namespace
+
+// Checks the order in which StorageScheduler hands out turns on a board. The
+// holder of the first turn is an interactive read, so one interactive turn is
+// already used up when the queued requests start.
+int main() {
+    SchedulingOptions options;
+    options.interactivePerWrite = 4;
+    options.bulkPromotionDelay = std::chrono::seconds(10);
+
+    expectOrder("interactive first, a write every interactivePerWrite turns, bulk last",
+                runQueued(options, {bulk("B1"), write("W1"), interactive("I1"), interactive("I2"), interactive("I3"),
+                                    interactive("I4"), interactive("I5"), interactive("I6"), interactive("I7"),
+                                    write("W2"), interactive("I8"), interactive("I9")},
+                          std::chrono::milliseconds(0)),
+                "I1 I2 I3 W1 I4 I5 I6 I7 W2 I8 I9 B1");
+
+    expectOrder("writes and bulk in their own order without interactive reads",
+                runQueued(options, {bulk("B1"), write("W1"), bulk("B2"), write("W2")}, std::chrono::milliseconds(0)),
+                "W1 W2 B1 B2");
+
+    options.interactivePerWrite = 2;
+    options.bulkPromotionDelay = std::chrono::milliseconds(20);
+
+    expectOrder("bulk waiting past the promotion delay is served like a write",
+                runQueued(options, {bulk("B1"), interactive("I1"), interactive("I2"), interactive("I3"), interactive("I4")},
+                          std::chrono::milliseconds(100)),
+                "I1 B1 I2 I3 I4");
+
+    expectOrder("promoted bulk and writes take the write share in arrival order",
+                runQueued(options, {write("W1"), bulk("B1"), write("W2"), interactive("I1"), interactive("I2"), interactive("I3")},
+                          std::chrono::milliseconds(100)),
+                "I1 W1 I2 I3 B1 W2");
+
+    return failures == 0 ? 0 : 1;
+}
@@ -1,10 +1,18 @@
+import os
 import sqlite3
+import subprocess
+import time
 from datetime import datetime
 from pathlib import Path
 
 import pytest
+import requests
 
 DATABASE_LOCATION = 'data/kanban-board.db'
+# started by the service fixture for tests that need other settings than the running service
+SERVICE_BINARY = os.environ.get('KANBAN_SERVICE', 'build/Service')
+# the service looks for writes made behind its back every KANBAN_VERSION_CHECK_MS, 20 by default
+OUTSIDE_WRITE_DELAY = 0.1
 
 
 def pytest_terminal_summary(terminalreporter, exitstatus, config):
@@ -50,11 +58,17 @@ def db_with_data(db_connection):
     clear_database(db_connection)
 
 
+def commit_outside(db_conn):
+    """commits a write made behind the service's back and waits until the service has seen it"""
+    db_conn.commit()
+    time.sleep(OUTSIDE_WRITE_DELAY)
+
+
 def clear_database(db_conn):
     cursor = db_conn.cursor()
     cursor.execute("DELETE FROM column")
     cursor.execute("DELETE FROM item")
-    db_conn.commit()
+    commit_outside(db_conn)
 
 
 def create_dummy_data(db_conn):
@@ -68,6 +82,38 @@ def create_dummy_data(db_conn):
              (3, "running task 2", datetime.now(), 2, 2)]
 
     cursor.executemany("INSERT INTO column VALUES(?, ?, ?)", columns)
-    cursor.executemany("INSERT INTO item VALUES (?, ?, ?, ?, ?)", items)
+    cursor.executemany("INSERT INTO item (id, title, date, position, column_id) VALUES (?, ?, ?, ?, ?)", items)
 
-    db_conn.commit()
+    commit_outside(db_conn)
+
+
+@pytest.fixture
+def service(tmp_path):
+    """start(port, **settings) runs another service with its own database in
+    tmp_path and the given KANBAN_* settings, and returns its api uri"""
+    processes = []
+
+    def start(port, **settings):
+        binary = Path(SERVICE_BINARY)
+        if not binary.is_file():
+            pytest.skip("service binary not found, set KANBAN_SERVICE")
+
+        environment = dict(os.environ, KANBAN_PORT=str(port), KANBAN_LOG_LEVEL='warning',
+                           KANBAN_DATABASE_FILE=str(tmp_path / 'kanban-board.db'), **settings)
+        processes.append(subprocess.Popen([str(binary.resolve())], cwd=tmp_path, env=environment,
+                                          stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL))
+
+        base_uri = 'http://127.0.0.1:' + str(port) + '/api/'
+        for _ in range(50):
+            try:
+                requests.get(base_uri + 'board')
+                return base_uri
+            except requests.exceptions.ConnectionError:
+                time.sleep(0.1)
+        pytest.fail("service on port " + str(port) + " did not start")
+
+    yield start
+
+    for process in processes:
+        process.terminate()
+        process.wait()
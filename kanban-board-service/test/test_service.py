@@ -1,7 +1,17 @@
 
+import os
+import sqlite3
+import subprocess
+import time
+from datetime import datetime
+from concurrent.futures import ThreadPoolExecutor
+from pathlib import Path
+
 import pytest
 import requests
 
+from conftest import DATABASE_LOCATION, SERVICE_BINARY, commit_outside
+
 BASE_URI = 'http://0.0.0.0:8080/api/'
 
 
@@ -275,3 +285,477 @@ def test_items_delete(db_with_data):
   column_id, deleted_item = get_item_by_id(ITEM_ID, db_with_data)
   assert column_id is None
   assert deleted_item is None
+
+def test_changes_without_version_is_snapshot(db_with_data):
+  resp = requests.get(BASE_URI + 'board/changes')
+  assert resp.status_code == 200
+
+  resp_body = resp.json()
+  assert resp_body.get('snapshot') == True
+  assert resp_body.get('version') > 0
+  assert len(resp_body['board']['columns']) == 3
+
+def test_changes_since_version(db_with_data):
+  version = requests.get(BASE_URI + 'board/changes').json().get('version')
+
+  payload = {'title': "test_item_changes", 'position': 3}
+  posted_item = requests.post(BASE_URI + 'board/columns/2/items', json=payload).json()
+  requests.delete(BASE_URI + 'board/columns/2/items/' + str(posted_item.get('id')))
+
+  resp = requests.get(BASE_URI + 'board/changes?since=' + str(version))
+  assert resp.status_code == 200
+
+  resp_body = resp.json()
+  assert resp_body.get('snapshot') == False
+  assert resp_body.get('version') == version + 2
+
+  changes = resp_body.get('changes')
+  assert [change.get('operation') for change in changes] == ['insert', 'delete']
+  assert changes[0].get('type') == 'item'
+  assert changes[0].get('columnId') == 2
+  assert changes[0].get('title') == 'test_item_changes'
+  assert changes[1].get('id') == posted_item.get('id')
+
+  resp = requests.get(BASE_URI + 'board/changes?since=' + str(version + 2))
+  assert resp.json().get('changes') == []
+
+def test_boards_are_separate(db_with_data):
+  BOARD_ID = 7
+  resp = requests.put(BASE_URI + 'boards/' + str(BOARD_ID))
+  assert resp.status_code in [200, 201]
+  assert requests.put(BASE_URI + 'boards/' + str(BOARD_ID)).status_code == 200
+
+  payload = {'name': "test_board_column", 'position': 1}
+  resp = requests.post(BASE_URI + 'boards/' + str(BOARD_ID) + '/columns', json=payload)
+  assert resp.status_code == 201
+  posted_column_id = resp.json().get('id')
+
+  payload = {'title': "test_board_item", 'position': 1}
+  resp = requests.post(BASE_URI + 'boards/' + str(BOARD_ID) + '/columns/' + str(posted_column_id) + '/items', json=payload)
+  assert resp.status_code == 201
+
+  resp_body = requests.get(BASE_URI + 'boards/' + str(BOARD_ID)).json()
+  assert resp_body['title'] == "Kanban Board " + str(BOARD_ID)
+  assert [column['name'] for column in resp_body['columns']] == ['test_board_column']
+  assert resp_body['columns'][0]['items'][0]['title'] == 'test_board_item'
+
+  # the default board only sees its own data
+  resp_body = requests.get(BASE_URI + 'board').json()
+  assert len(resp_body['columns']) == 3
+  assert resp_body == requests.get(BASE_URI + 'boards/0').json()
+
+  requests.delete(BASE_URI + 'boards/' + str(BOARD_ID) + '/columns/' + str(posted_column_id))
+  assert requests.get(BASE_URI + 'boards/' + str(BOARD_ID)).json()['columns'] == []
+
+def test_boards_invalid_id(db_with_data):
+  resp = requests.get(BASE_URI + 'boards/-1')
+  assert resp.status_code == 404
+
+def test_boards_unknown_id(db_with_data):
+  BOARD_ID = 2147483000
+  for path in ['', '/changes', '/search', '/archive', '/columns', '/columns/1', '/columns/1/items', '/columns/1/items/1']:
+    assert requests.get(BASE_URI + 'boards/' + str(BOARD_ID) + path).status_code == 404
+
+  resp = requests.post(BASE_URI + 'boards/' + str(BOARD_ID) + '/columns', json={'name': 'nowhere', 'position': 1})
+  assert resp.status_code == 404
+  # nothing but PUT /api/boards/<id> creates a board's file
+  assert not Path(DATABASE_LOCATION).parent.joinpath('boards', 'kanban-board-' + str(BOARD_ID) + '.db').exists()
+
+def test_search_items(db_with_data):
+  resp = requests.get(BASE_URI + 'board/search', params={'q': 'running task'})
+  assert resp.status_code == 200
+
+  resp_body = resp.json()
+  assert sorted(hit.get('id') for hit in resp_body) == [2, 3]
+  assert all(hit.get('columnId') == 2 for hit in resp_body)
+
+  # the last word matches as a prefix, search-as-you-type style
+  resp_body = requests.get(BASE_URI + 'board/search', params={'q': 'pla'}).json()
+  assert [hit.get('title') for hit in resp_body] == ['in plan']
+
+  resp_body = requests.get(BASE_URI + 'board/search', params={'q': 'task', 'limit': 1, 'offset': 1}).json()
+  assert len(resp_body) == 1
+
+def test_search_items_follows_updates(db_with_data):
+  payload = {'title': "renamed card", 'position': 1}
+  requests.put(BASE_URI + 'board/columns/1/items/1', json=payload)
+
+  assert requests.get(BASE_URI + 'board/search', params={'q': 'plan'}).json() == []
+  assert [hit.get('id') for hit in requests.get(BASE_URI + 'board/search', params={'q': 'renamed'}).json()] == [1]
+
+def test_search_items_odd_input(db_with_data):
+  for query in ['', '"', 'AND OR', 'task)(*', "' or 1=1 --"]:
+    resp = requests.get(BASE_URI + 'board/search', params={'q': query})
+    assert resp.status_code == 200
+    assert isinstance(resp.json(), list)
+
+def test_archive_get(db_with_data):
+  resp = requests.get(BASE_URI + 'board/archive', params={'limit': 5})
+  assert resp.status_code == 200
+
+  resp_body = resp.json()
+  assert isinstance(resp_body, list)
+  assert len(resp_body) <= 5
+
+def test_archive_moves_stale_items(service, tmp_path):
+  base_uri = service(8092, KANBAN_ARCHIVE_COLUMNS='finished', KANBAN_ARCHIVE_INTERVAL_SECONDS='1',
+                     KANBAN_ARCHIVE_MAX_AGE_SECONDS='3600')
+
+  finished = requests.post(base_uri + 'board/columns', json={'name': 'finished', 'position': 1}).json()
+  running = requests.post(base_uri + 'board/columns', json={'name': 'running', 'position': 2}).json()
+  stale = requests.post(base_uri + 'board/columns/' + str(finished['id']) + '/items', json={'title': 'stale', 'position': 1}).json()
+  requests.post(base_uri + 'board/columns/' + str(finished['id']) + '/items', json={'title': 'fresh', 'position': 2})
+  other = requests.post(base_uri + 'board/columns/' + str(running['id']) + '/items', json={'title': 'old elsewhere', 'position': 1}).json()
+
+  # two hours ago, past the cutoff of one hour
+  conn = sqlite3.connect(str(tmp_path / 'kanban-board.db'))
+  conn.execute("UPDATE item SET modified = CAST(strftime('%s', 'now') AS INTEGER) - 7200 WHERE id IN (?, ?)", (stale['id'], other['id']))
+  conn.commit()
+  conn.close()
+
+  for _ in range(50):
+    archived = requests.get(base_uri + 'board/archive').json()
+    if archived:
+      break
+    time.sleep(0.1)
+
+  assert [(item['id'], item['title'], item['columnName']) for item in archived] == [(stale['id'], 'stale', 'finished')]
+
+  columns = {column['name']: column for column in requests.get(base_uri + 'board').json()['columns']}
+  assert [item['title'] for item in columns['finished']['items']] == ['fresh']
+  assert [item['id'] for item in columns['running']['items']] == [other['id']]
+
+def test_admin_backup(db_with_data):
+  resp = requests.post(BASE_URI + 'admin/backup')
+  assert resp.status_code == 202
+  assert resp.json().get('status') in ['started', 'running']
+
+  for _ in range(50):
+    metrics = requests.get(BASE_URI + 'admin/metrics').text
+    if 'kanban_backup_last_success_timestamp_seconds{board="0"}' in metrics:
+      break
+    time.sleep(0.1)
+
+  assert 'kanban_backup_last_success_timestamp_seconds{board="0"}' in metrics
+  assert 'kanban_backup_duration_seconds_count{board="0"}' in metrics
+
+def test_wal_checkpoint_when_idle(db_with_data):
+  resp = requests.post(BASE_URI + 'board/columns', json={'name': 'checkpointed', 'position': 9})
+  assert resp.status_code == 201
+
+  for _ in range(50):
+    metrics = requests.get(BASE_URI + 'admin/metrics').text
+    if 'kanban_wal_checkpoints_total{board="0",mode="passive"}' in metrics:
+      break
+    time.sleep(0.1)
+
+  assert 'kanban_wal_size_bytes{board="0"}' in metrics
+  assert 'kanban_wal_checkpoints_total{board="0",mode="passive"}' in metrics
+  assert 'kanban_wal_checkpoint_duration_seconds_count{board="0",mode="passive"}' in metrics
+
+def test_admin_queries(db_with_data):
+  requests.get(BASE_URI + 'board')
+  requests.get(BASE_URI + 'board/columns/1/items/1')
+
+  resp = requests.get(BASE_URI + 'admin/queries?limit=100')
+  assert resp.status_code == 200
+
+  statements = {entry['statement']: entry for entry in resp.json()}
+  assert 'select * from column order by position' in statements
+  # literals are folded, every item lookup lands in the same entry
+  assert 'select id, title, position, created, date from item where column_id = ? and id = ?' in statements
+  assert statements['select * from column order by position']['count'] >= 1
+
+  resp = requests.get(BASE_URI + 'admin/queries?limit=1')
+  assert len(resp.json()) == 1
+
+def storage_turns(requestClass):
+  # how many turns of this class the boards' schedulers have handed out so far
+  metric = 'kanban_storage_queue_delay_seconds_count{class="' + requestClass + '"} '
+  for line in requests.get(BASE_URI + 'admin/metrics').text.splitlines():
+    if line.startswith(metric):
+      return int(float(line[len(metric):]))
+  return 0
+
+def test_admin_storage(db_with_data):
+  requests.get(BASE_URI + 'board')
+  bulk_turns = storage_turns('bulk')
+
+  resp = requests.get(BASE_URI + 'admin/storage')
+  assert resp.status_code == 200
+  body = resp.json()
+
+  # the pragmas behind the report wait for a turn of every open board, as bulk work
+  assert storage_turns('bulk') - bulk_turns >= len(body['boards']) > 0
+
+  assert body['memory']['memoryUsed']['highwater'] >= body['memory']['memoryUsed']['current'] > 0
+
+  board = next(board for board in body['boards'] if board['id'] == 0)
+  assert board['databaseBytes'] > 0 and board['pageSize'] > 0
+  assert board['cache']['hits'] + board['cache']['misses'] > 0
+  assert board['schemaBytes'] > 0
+
+def test_board_concurrent_reads(db_with_data):
+  expected = requests.get(BASE_URI + 'board').json()
+
+  with ThreadPoolExecutor(max_workers=16) as executor:
+    responses = list(executor.map(lambda _: requests.get(BASE_URI + 'board'), range(64)))
+
+  assert all(resp.status_code == 200 for resp in responses)
+  assert all(resp.json() == expected for resp in responses)
+
+  # a write between two reads is never hidden by a shared result
+  requests.post(BASE_URI + 'board/columns', json={'name': 'after', 'position': 9})
+  names = [column['name'] for column in requests.get(BASE_URI + 'board').json()['columns']]
+  assert 'after' in names
+
+def test_board_reflects_item_changes(db_with_data):
+  before = requests.get(BASE_URI + 'board').json()
+
+  # written behind the service's back, only the first column changes
+  cursor = db_with_data.cursor()
+  cursor.execute("UPDATE item SET title = 'renamed' WHERE id = 1")
+  commit_outside(db_with_data)
+
+  after = requests.get(BASE_URI + 'board').json()
+  assert after['columns'][0]['items'][0]['title'] == 'renamed'
+  assert after['columns'][1:] == before['columns'][1:]
+
+  resp = requests.post(BASE_URI + 'board/columns/2/items', json={'title': 'new item', 'position': 5})
+  assert resp.status_code == 201
+
+  columns = requests.get(BASE_URI + 'board/columns').json()
+  assert 'new item' in [item['title'] for item in columns[1]['items']]
+  assert columns[0]['items'][0]['title'] == 'renamed'
+
+def test_admission_sheds_writes_over_limit(service):
+  base_uri = service(8093, KANBAN_THREADS='8', KANBAN_ADMISSION_MAX_WRITES='1')
+  column = requests.post(base_uri + 'board/columns', json={'name': 'load', 'position': 1}).json()
+
+  def post_item(i):
+    with requests.Session() as session:
+      return [session.post(base_uri + 'board/columns/' + str(column['id']) + '/items', json={'title': 'item ' + str(i), 'position': i * 10 + j})
+              for j in range(8)]
+
+  with ThreadPoolExecutor(max_workers=16) as executor:
+    responses = [resp for batch in executor.map(post_item, range(16)) for resp in batch]
+
+  shed = [resp for resp in responses if resp.status_code == 503]
+  assert shed and all(resp.headers.get('Retry-After') == '1' for resp in shed)
+  assert all(resp.status_code in [201, 503] for resp in responses)
+
+  # shed writes are not applied, reads are admitted separately
+  resp = requests.get(base_uri + 'board/columns/' + str(column['id']) + '/items')
+  assert resp.status_code == 200
+  assert len(resp.json()) == len(responses) - len(shed)
+
+  metrics = requests.get(base_uri + 'admin/metrics').text
+  assert 'kanban_admission_rejected_total{class="write"} ' + str(len(shed)) in metrics
+
+def test_expired_deadline(db_with_data):
+  resp = requests.get(BASE_URI + 'board', headers={'X-Request-Timeout-Ms': '0'})
+  assert resp.status_code == 503
+
+  resp = requests.post(BASE_URI + 'board/columns', json={'name': 'late', 'position': 9},
+                       headers={'X-Request-Timeout-Ms': '0'})
+  assert resp.status_code == 503
+  names = [column['name'] for column in requests.get(BASE_URI + 'board').json()['columns']]
+  assert 'late' not in names
+
+  resp = requests.get(BASE_URI + 'board', headers={'X-Request-Timeout-Ms': '5000'})
+  assert resp.status_code == 200
+
+  # cut down to KANBAN_MAX_TIMEOUT_MS instead of wrapping around into the past
+  resp = requests.get(BASE_URI + 'board', headers={'X-Request-Timeout-Ms': '9223372036854775'})
+  assert resp.status_code == 200
+
+def test_storage_turns_are_counted_per_class(db_with_data):
+  # the order of the turns is checked by StorageSchedulerTest, this checks that
+  # requests wait for the board in the class their method and header give them
+  before = {requestClass: storage_turns(requestClass) for requestClass in ['interactive', 'write', 'bulk']}
+
+  for _ in range(3):
+    assert requests.get(BASE_URI + 'board/search', params={'q': 'task'}).status_code == 200
+  for position in [9, 10]:
+    resp = requests.post(BASE_URI + 'board/columns', json={'name': 'import', 'position': position},
+                         headers={'X-Request-Priority': 'bulk'})
+    assert resp.status_code == 201
+  resp = requests.put(BASE_URI + 'board/columns/' + str(resp.json()['id']), json={'name': 'imported', 'position': 10})
+  assert resp.status_code == 200
+
+  # reads other than searches are answered from the snapshot, and every write
+  # refreshes the snapshot during turns of the write class
+  assert storage_turns('interactive') - before['interactive'] == 3
+  assert storage_turns('bulk') - before['bulk'] >= 2
+  assert storage_turns('write') - before['write'] >= 1 + 3
+def test_reads_follow_api_and_database_writes(db_with_data):
+  # warms the snapshot, the writes below have to replace it
+  assert requests.get(BASE_URI + 'board/columns/1/items/1').json()['title'] == 'in plan'
+
+  resp = requests.put(BASE_URI + 'board/columns/1/items/1', json={'title': 'planned', 'position': 1})
+  assert resp.status_code == 200
+  assert requests.get(BASE_URI + 'board/columns/1/items/1').json()['title'] == 'planned'
+
+  cursor = db_with_data.cursor()
+  cursor.execute("INSERT INTO item (id, title, date, position, column_id) VALUES (9, 'outside', 'now', 3, 2)")
+  commit_outside(db_with_data)
+
+  titles = [item['title'] for item in requests.get(BASE_URI + 'board/columns/2/items').json()]
+  assert 'outside' in titles
+  assert requests.get(BASE_URI + 'board/columns/1/items/9').json() == {}
+
+def test_outside_writes_are_picked_up_without_reads(service, tmp_path):
+  base_uri = service(8094, KANBAN_VERSION_CHECK_MS='200')
+  column = requests.post(base_uri + 'board/columns', json={'name': 'todo', 'position': 1}).json()
+  items_uri = base_uri + 'board/columns/' + str(column['id']) + '/items'
+
+  # writes through the api are seen by the next read, whatever the interval
+  requests.post(items_uri, json={'title': 'through the api', 'position': 1})
+  assert [item['title'] for item in requests.get(items_uri).json()] == ['through the api']
+
+  conn = sqlite3.connect(str(tmp_path / 'kanban-board.db'))
+  conn.execute("INSERT INTO item (title, date, position, column_id) VALUES ('outside', 'now', 2, ?)", (column['id'],))
+  conn.commit()
+  conn.close()
+
+  # no read in between, the snapshot is replaced in the background
+  time.sleep(1)
+  assert [item['title'] for item in requests.get(items_uri).json()] == ['through the api', 'outside']
+
+def service_cpu_seconds(port):
+  # user and system time of the service started on port, from /proc
+  for stat in Path('/proc').glob('[0-9]*/stat'):
+    try:
+      if ('KANBAN_PORT=' + str(port)).encode() in (stat.parent / 'environ').read_bytes().split(b'\0'):
+        fields = stat.read_text().rsplit(')', 1)[1].split()
+        return (int(fields[11]) + int(fields[12])) / os.sysconf('SC_CLK_TCK')
+    except OSError:
+      pass
+  pytest.skip("service process not found in /proc")
+
+def test_intervals_below_their_minimum_fall_back(service):
+  base_uri = service(8096, KANBAN_ARCHIVE_INTERVAL_SECONDS='0', KANBAN_CHECKPOINT_INTERVAL_MS='-5',
+                     KANBAN_VERSION_CHECK_MS='0', KANBAN_READ_TIMEOUT_MS='0')
+  assert requests.get(base_uri + 'board').status_code == 200
+
+  # periodic tasks that do not wait between runs would keep a core busy
+  before = service_cpu_seconds(8096)
+  time.sleep(1)
+  assert service_cpu_seconds(8096) - before < 0.3
+
+def test_items_with_large_ids_and_foreign_dates(db_with_data):
+  cursor = db_with_data.cursor()
+  cursor.execute("INSERT INTO item (id, title, date, position, column_id) VALUES (5000000000, 'a title longer than fifteen characters', '2024-01-02 03:04:05', 3, 2)")
+  commit_outside(db_with_data)
+
+  resp = requests.get(BASE_URI + 'board/columns/2/items/5000000000')
+  assert resp.status_code == 200
+
+  resp_body = resp.json()
+  assert resp_body.get('id') == 5000000000
+  assert resp_body.get('title') == 'a title longer than fifteen characters'
+  # dates written by other tools are answered as they are stored
+  assert resp_body.get('timestamp') == '2024-01-02 03:04:05'
+
+def test_items_store_their_time_as_unix_time(db_with_data):
+  resp = requests.post(BASE_URI + 'board/columns/2/items', json={'title': 'timed', 'position': 5})
+  assert resp.status_code == 201
+  item = resp.json()
+
+  created, date = db_with_data.cursor().execute('SELECT created, date FROM item WHERE id = ?', (item['id'],)).fetchone()
+  assert datetime.fromtimestamp(created).ctime() == date == item['timestamp']
+
+def test_items_keep_dates_that_are_no_timestamp(db_with_data):
+  cursor = db_with_data.cursor()
+  cursor.execute("INSERT INTO item (id, title, date, position, column_id) VALUES (5000000001, 'undated', 'sometime in spring', 4, 2)")
+  commit_outside(db_with_data)
+
+  resp = requests.get(BASE_URI + 'board/columns/2/items/5000000001')
+  assert resp.status_code == 200
+  assert resp.json().get('timestamp') == 'sometime in spring'
+
+  resp = requests.put(BASE_URI + 'board/columns/2/items/5000000001', json={'title': 'still undated', 'position': 4})
+  assert resp.status_code == 200
+  assert resp.json().get('timestamp') == 'sometime in spring'
+
+def test_migration_fills_in_created_only_for_service_dates(service, tmp_path):
+  # a database as schema version 5 left it, before item times were stored as unix time
+  written = datetime(2024, 1, 2, 3, 4, 5)
+  conn = sqlite3.connect(str(tmp_path / 'kanban-board.db'))
+  conn.executescript("""
+    create table column (id integer not null primary key autoincrement, name text not null, position integer not null unique);
+    create table item (id integer not null primary key autoincrement, title text not null, date text not null,
+                       position integer not null, column_id integer not null, modified integer not null default 0);
+    create table change_log (seq integer not null primary key autoincrement, entity text not null, operation text not null,
+                             entity_id integer not null, column_id integer not null, name text, position integer, date text);
+    create table item_archive (id integer not null primary key, title text not null, date text not null, position integer not null,
+                               column_id integer not null, column_name text not null, archived integer not null);
+    insert into column (id, name, position) values (1, 'todo', 1);
+    pragma user_version = 5;
+  """)
+  conn.executemany("INSERT INTO item (id, title, date, position, column_id) VALUES (?, ?, ?, ?, 1)",
+                   [(1, 'by the service', written.ctime(), 1), (2, 'by another tool', '2024-01-02 03:04:05', 2),
+                    (3, 'with a note', written.ctime() + ' or so', 3)])
+  conn.commit()
+
+  base_uri = service(8095)
+  items = requests.get(base_uri + 'board/columns/1/items').json()
+  assert [item['timestamp'] for item in items] == [written.ctime(), '2024-01-02 03:04:05', written.ctime() + ' or so']
+
+  created = [row[0] for row in conn.execute('SELECT created FROM item ORDER BY id')]
+  assert created == [int(written.timestamp()), None, None]
+  conn.close()
+
+# every where / order by shape used in BoardRepository.cpp, with the table a
+# shape may scan because it stays small whatever the board holds
+HOT_QUERIES = [
+  ("select * from column order by position", None),
+  ("select id, name, position from column where id = '2'", None),
+  ("update column set name = 'x', position = 5 where id = 2", None),
+  ("delete from column where id = 2", None),
+  ("select id, title, position, created, date from item where column_id = 2 order by position", None),
+  ("select id, title, position, created, date from item where column_id = 2 and id = 2", None),
+  ("update item set title = 'x', position = '3' where id = 2 and column_id = 2", None),
+  ("delete from item where id = 2 and column_id = 2", None),
+  ("select seq, entity, operation, column_id, entity_id, name, position, created, date from change_log where seq > 5 order by seq", None),
+  # one row per table with autoincrement ids
+  ("select seq from sqlite_sequence where name = 'change_log'", 'sqlite_sequence'),
+  # fts5 answers the match from its own index
+  ("select item.id, item.title, item.position, item.created, item.date, item.column_id from item_fts "
+   "join item on item.id = item_fts.rowid where item_fts match '\"plan\"*' order by item_fts.rank limit 20 offset 0", 'item_fts'),
+  ("select id, title, position, created, date, column_id, column_name, archived from item_archive order by archived desc, id desc limit 20 offset 0", None),
+  # the archive job finds its columns by name, a board has a handful of columns
+  ("select item.id from item join column on column.id = item.column_id "
+   "where column.name in ('finished') and item.modified > 0 and item.modified < 5 limit 500", 'column'),
+  ("insert or replace into item_archive (id, title, date, created, position, column_id, column_name, archived) "
+   "select item.id, item.title, item.date, item.created, item.position, item.column_id, column.name, 5 "
+   "from item join column on column.id = item.column_id where item.id in (1,2)", None),
+  ("delete from item where id in (1,2)", None),
+]
+
+def test_hot_queries_use_indexes(db_with_data):
+  cursor = db_with_data.cursor()
+
+  for query, small_table in HOT_QUERIES:
+    plan = [row[3] for row in cursor.execute("explain query plan " + query)]
+
+    for step in plan:
+      assert not step.startswith('USE TEMP B-TREE'), query + ' -> ' + step
+      # a scan is only fine when it walks an index, i.e. for unfiltered ordered reads
+      if step.startswith('SCAN') and not (small_table and step.split()[1] == small_table):
+        assert 'USING' in step and ' where ' not in query, query + ' -> ' + step
+
+@pytest.mark.skipif(os.name == 'nt', reason="windows builds have no unix socket listener")
+def test_service_stops_when_its_unix_socket_cannot_be_bound(tmp_path):
+  binary = Path(SERVICE_BINARY)
+  if not binary.is_file():
+    pytest.skip("service binary not found, set KANBAN_SERVICE")
+
+  # the socket alone and next to tcp, neither goes on without it
+  for port in ['0', '8097']:
+    environment = dict(os.environ, KANBAN_PORT=port, KANBAN_LOG_LEVEL='warning',
+                       KANBAN_DATABASE_FILE=str(tmp_path / 'kanban-board.db'),
+                       KANBAN_UNIX_SOCKET=str(tmp_path / 'missing' / 'service.sock'))
+    process = subprocess.run([str(binary.resolve())], cwd=tmp_path, env=environment,
+                             stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL, timeout=10)
+    assert process.returncode == 1, 'KANBAN_PORT=' + port
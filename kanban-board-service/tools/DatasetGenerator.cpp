@@ -0,0 +1,192 @@
+#include "Repository/SQLite/BulkLoader.hpp"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include <filesystem>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace Prog3::Repository::SQLite;
+
+namespace {
+
+struct Options {
+    std::string output;
+    bool replace = false;
+    int columns = 8;
+    std::int64_t items = 100000;
+    // zipf exponent of the items over the columns, 0 spreads them evenly
+    double columnSkew = 1.0;
+    double titleWordsMean = 5;
+    int titleWordsMax = 24;
+    double ageDaysMean = 60;
+    double ageDaysMax = 730;
+    std::uint64_t seed = 1;
+    // unix time the ages count back from, fixed so a seed always gives the same file
+    std::int64_t now = 1704067200;
+};
+
+std::array<char const *, 64> const WORDS = {
+    "fix", "add", "update", "remove", "refactor", "review", "deploy", "test", "document", "migrate",
+    "login", "search", "board", "column", "item", "cache", "index", "query", "api", "client",
+    "server", "backup", "archive", "metrics", "alert", "dashboard", "release", "build", "pipeline", "config",
+    "timeout", "retry", "crash", "leak", "latency", "throughput", "upgrade", "dependency", "schema", "report",
+    "export", "import", "user", "team", "permission", "token", "session", "email", "notification", "billing",
+    "invoice", "payment", "mobile", "desktop", "layout", "style", "font", "icon", "translation", "onboarding",
+    "tracking", "audit", "cleanup", "spike"};
+
+std::array<char const *, 8> const COLUMN_NAMES = {"backlog", "prepare", "ready", "running", "review", "testing", "done", "finished"};
+
+// items per column, column c gets a share proportional to 1 / c^skew
+std::vector<std::int64_t> getColumnSizes(Options const &options) {
+    std::vector<double> weights;
+    double total = 0;
+    for (int c = 1; c <= options.columns; c++) {
+        weights.push_back(1.0 / std::pow(c, options.columnSkew));
+        total += weights.back();
+    }
+
+    std::vector<std::int64_t> sizes;
+    std::int64_t assigned = 0;
+    for (double weight : weights) {
+        sizes.push_back(static_cast<std::int64_t>(options.items * weight / total));
+        assigned += sizes.back();
+    }
+    sizes.front() += options.items - assigned;
+
+    return sizes;
+}
+
+bool parseOptions(int argc, char **argv, Options &options) {
+    for (int i = 1; i < argc; i++) {
+        std::string name = argv[i];
+        if (name == "--replace") {
+            options.replace = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            return false;
+        }
+
+        std::string value = argv[++i];
+        if (name == "--output") {
+            options.output = value;
+        } else if (name == "--columns") {
+            options.columns = std::max(1, std::stoi(value));
+        } else if (name == "--items") {
+            options.items = std::max<std::int64_t>(0, std::stoll(value));
+        } else if (name == "--column-skew") {
+            options.columnSkew = std::max(0.0, std::stod(value));
+        } else if (name == "--title-words-mean") {
+            options.titleWordsMean = std::max(1.0, std::stod(value));
+        } else if (name == "--title-words-max") {
+            options.titleWordsMax = std::max(1, std::stoi(value));
+        } else if (name == "--age-days-mean") {
+            options.ageDaysMean = std::max(0.0, std::stod(value));
+        } else if (name == "--age-days-max") {
+            options.ageDaysMax = std::max(0.0, std::stod(value));
+        } else if (name == "--seed") {
+            options.seed = std::stoull(value);
+        } else if (name == "--now") {
+            options.now = std::stoll(value);
+        } else {
+            return false;
+        }
+    }
+
+    return !options.output.empty();
+}
+
+void printUsage() {
+    std::cerr << "usage: DatasetGenerator --output <file.db> [options]\n"
+                 "  --replace               overwrite an existing file\n"
+                 "  --columns <n>           columns (8)\n"
+                 "  --items <n>             items over all columns (100000)\n"
+                 "  --column-skew <s>       zipf exponent of items per column, 0 = even (1.0)\n"
+                 "  --title-words-mean <n>  mean words per title (5)\n"
+                 "  --title-words-max <n>   most words per title (24)\n"
+                 "  --age-days-mean <n>     mean item age in days, exponentially distributed (60)\n"
+                 "  --age-days-max <n>      oldest item age in days (730)\n"
+                 "  --seed <n>              random seed (1)\n"
+                 "  --now <unix time>       time the ages count back from (1704067200)\n";
+}
+
+} // namespace
+
+// Generates a board database of the given shape, the same file for the same
+// options and seed. The file can be opened by the service as a board, by
+// HotPathBenchmark --database, or used for profiling.
+int main(int argc, char **argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage();
+        return 2;
+    }
+
+    if (std::filesystem::exists(options.output)) {
+        if (!options.replace) {
+            std::cerr << options.output << " exists, use --replace to overwrite it" << std::endl;
+            return 1;
+        }
+        for (char const *suffix : {"", "-wal", "-shm", "-journal"}) {
+            std::filesystem::remove(options.output + suffix);
+        }
+    }
+
+    auto started = std::chrono::steady_clock::now();
+    std::mt19937_64 random(options.seed);
+    // 1 + poisson keeps titles at one word at least with the requested mean
+    std::poisson_distribution<int> extraWords(std::max(options.titleWordsMean - 1, 1e-9));
+    std::uniform_int_distribution<std::size_t> word(0, WORDS.size() - 1);
+    std::exponential_distribution<double> ageDays(options.ageDaysMean > 0 ? 1.0 / options.ageDaysMean : 1e9);
+    std::uniform_real_distribution<double> unit(0, 1);
+
+    std::vector<std::int64_t> columnSizes = getColumnSizes(options);
+    BulkLoader loader(options.output);
+    std::string title;
+
+    for (int c = 1; c <= options.columns; c++) {
+        std::string name = COLUMN_NAMES[(c - 1) % COLUMN_NAMES.size()];
+        if (c > static_cast<int>(COLUMN_NAMES.size())) {
+            name += " " + std::to_string(c);
+        }
+        loader.addColumn(c, name, c);
+
+        for (std::int64_t i = 1; i <= columnSizes[c - 1]; i++) {
+            int words = std::min(options.titleWordsMax, 1 + extraWords(random));
+            title.clear();
+            for (int w = 0; w < words; w++) {
+                if (w > 0) {
+                    title += ' ';
+                }
+                title += WORDS[word(random)];
+            }
+
+            double age = std::min(ageDays(random), options.ageDaysMax);
+            std::int64_t created = options.now - static_cast<std::int64_t>(age * 86400);
+            std::int64_t modified = created + static_cast<std::int64_t>((options.now - created) * unit(random) * unit(random));
+
+            loader.addItem(c, title, static_cast<int>(i), created, modified);
+        }
+    }
+
+    if (!loader.finish()) {
+        std::cerr << "loading " << options.output << " failed" << std::endl;
+        return 1;
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    std::printf("%s: %d columns, %lld items in %.1f s (%.0f items/s)\n", options.output.c_str(), options.columns,
+                static_cast<long long>(options.items), seconds, options.items / seconds);
+    for (int c = 1; c <= options.columns; c++) {
+        std::printf("  column %d: %lld items\n", c, static_cast<long long>(columnSizes[c - 1]));
+    }
+
+    return 0;
+}
@@ -0,0 +1,675 @@
+#include "rapidjson/document.h"
+#include "rapidjson/prettywriter.h"
+#include "rapidjson/stringbuffer.h"
+#include <boost/asio.hpp>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using boost::asio::ip::tcp;
+// tcp or a unix domain socket, whichever the service is reached on
+using Socket = boost::asio::generic::stream_protocol::socket;
+using Endpoints = std::vector<boost::asio::generic::stream_protocol::endpoint>;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+enum Operation {
+    Read,
+    Post,
+    Put,
+    Move,
+    Delete,
+    OPERATION_COUNT
+};
+
+char const *const OPERATION_NAMES[OPERATION_COUNT] = {"read", "post", "put", "move", "delete"};
+
+struct Options {
+    std::string host = "127.0.0.1";
+    std::string port = "8080";
+    // connect to this unix domain socket instead of host and port
+    std::string unixSocket;
+    // path of the board below /api/, "boards/<id>" for the others
+    std::string board = "board";
+    int connections = 16;
+    int threads = 1;
+    std::chrono::seconds duration{10};
+    std::chrono::seconds warmup{2};
+    // requests per second over all connections, 0 sends the next request as soon as the answer is in
+    double rate = 0;
+    std::array<int, OPERATION_COUNT> mix = {60, 15, 10, 5, 10};
+    std::uint64_t seed = 1;
+    std::string jsonFile;
+    bool cleanup = true;
+};
+
+// latencies in microseconds, kept per connection and merged at the end
+struct Statistics {
+    std::array<std::vector<std::uint32_t>, OPERATION_COUNT> latencies;
+    std::array<std::uint64_t, OPERATION_COUNT> shed{};
+    std::array<std::uint64_t, OPERATION_COUNT> failed{};
+    std::uint64_t connectionErrors = 0;
+
+    void merge(Statistics const &other) {
+        for (int op = 0; op < OPERATION_COUNT; op++) {
+            latencies[op].insert(latencies[op].end(), other.latencies[op].begin(), other.latencies[op].end());
+            shed[op] += other.shed[op];
+            failed[op] += other.failed[op];
+        }
+        connectionErrors += other.connectionErrors;
+    }
+};
+
+struct Response {
+    int status = 0;
+    std::string body;
+};
+
+struct OwnItem {
+    std::int64_t columnId;
+    std::int64_t itemId;
+    int position;
+};
+
+std::string buildRequest(Options const &options, char const *method, std::string const &path, std::string const &body,
+                         bool keepAlive) {
+    std::ostringstream request;
+    request << method << " /api/" << options.board << path << " HTTP/1.1\r\n"
+            << "Host: " << options.host << ":" << options.port << "\r\n"
+            << "Connection: " << (keepAlive ? "keep-alive" : "close") << "\r\n";
+    if (!body.empty()) {
+        request << "Content-Type: application/json\r\n"
+                << "Content-Length: " << body.size() << "\r\n";
+    }
+    request << "\r\n"
+            << body;
+
+    return request.str();
+}
+
+std::string buildItemBody(std::string const &title, int position) {
+    return "{\"title\":\"" + title + "\",\"position\":" + std::to_string(position) + "}";
+}
+
+// status code and content length out of the response head, -1 if the head is broken
+int parseHead(std::string const &head, std::size_t &contentLength) {
+    int status = -1;
+    if (std::sscanf(head.c_str(), "HTTP/%*d.%*d %d", &status) != 1) {
+        return -1;
+    }
+
+    contentLength = 0;
+    std::istringstream lines(head);
+    std::string line;
+    while (std::getline(lines, line)) {
+        std::string lower(line.size(), ' ');
+        std::transform(line.begin(), line.end(), lower.begin(), [](unsigned char c) { return std::tolower(c); });
+        if (lower.rfind("content-length:", 0) == 0) {
+            contentLength = std::stoul(line.substr(15));
+        }
+    }
+
+    return status;
+}
+
+// one request on a fresh connection, for setting up and cleaning up the run
+Response fetch(boost::asio::io_service &io, Endpoints const &endpoints, std::string const &request) {
+    Socket socket(io);
+    boost::asio::connect(socket, endpoints);
+    boost::asio::write(socket, boost::asio::buffer(request));
+
+    boost::asio::streambuf buffer;
+    boost::system::error_code error;
+    boost::asio::read(socket, buffer, error);
+    if (error && error != boost::asio::error::eof) {
+        throw boost::system::system_error(error);
+    }
+
+    std::string raw(boost::asio::buffers_begin(buffer.data()), boost::asio::buffers_end(buffer.data()));
+    std::size_t headEnd = raw.find("\r\n\r\n");
+    std::size_t contentLength = 0;
+
+    Response response;
+    if (headEnd != std::string::npos) {
+        response.status = parseHead(raw.substr(0, headEnd), contentLength);
+        response.body = raw.substr(headEnd + 4);
+    }
+
+    return response;
+}
+
+std::int64_t getId(std::string const &json) {
+    rapidjson::Document document;
+    document.Parse(json.c_str());
+
+    if (document.HasParseError() || !document.IsObject() || !document.HasMember("id") || !document["id"].IsInt64()) {
+        return -1;
+    }
+
+    return document["id"].GetInt64();
+}
+
+// A keep-alive connection running the request mix in a loop. Without a rate
+// the next request goes out when the answer is in (closed loop). With a rate
+// requests are due on a fixed schedule and latency counts from the time a
+// request was due, so a slow answer is not hidden by the requests it delayed.
+class Connection {
+  public:
+    Connection(boost::asio::io_service &io, Options const &givenOptions, int givenIndex,
+               std::vector<std::int64_t> const &givenColumns, Clock::time_point givenMeasureFrom, Clock::time_point givenStopAt)
+        : socket(io), timer(io), options(givenOptions), index(givenIndex), columns(givenColumns),
+          measureFrom(givenMeasureFrom), stopAt(givenStopAt), random(givenOptions.seed * 1000003 + givenIndex),
+          nextPosition(POSITIONS_PER_CONNECTION * (givenIndex + 1)) {
+        if (options.rate > 0) {
+            interval = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(options.connections / options.rate));
+            // spreads the connections over one interval
+            due = Clock::now() + interval * index / options.connections;
+        }
+    }
+
+    void start(Endpoints const &endpoints) {
+        boost::asio::async_connect(socket, endpoints, [this](boost::system::error_code error, Endpoints::value_type const &) {
+            if (error) {
+                statistics.connectionErrors++;
+                return;
+            }
+            if (options.unixSocket.empty()) {
+                socket.set_option(tcp::no_delay(true));
+            }
+            next();
+        });
+    }
+
+    Statistics const &getStatistics() const {
+        return statistics;
+    }
+
+    std::vector<OwnItem> const &getOwnItems() const {
+        return ownItems;
+    }
+
+    // positions of different connections never collide in a column
+    static inline int const POSITIONS_PER_CONNECTION = 1000000;
+
+  private:
+    Socket socket;
+    boost::asio::steady_timer timer;
+    boost::asio::streambuf buffer;
+    Options const &options;
+    int const index;
+    std::vector<std::int64_t> const &columns;
+    Clock::time_point const measureFrom;
+    Clock::time_point const stopAt;
+    std::mt19937_64 random;
+    int nextPosition;
+    std::uint64_t sent = 0;
+
+    Clock::duration interval{0};
+    Clock::time_point due;
+
+    Operation operation = Read;
+    Clock::time_point started;
+    std::string request;
+    std::size_t contentLength = 0;
+    int status = 0;
+    // the item a post is for, the item a delete removed
+    OwnItem pending{};
+
+    std::vector<OwnItem> ownItems;
+    Statistics statistics;
+
+    void next() {
+        if (options.rate > 0) {
+            due += interval;
+            if (due >= stopAt) {
+                close();
+                return;
+            }
+            if (due > Clock::now()) {
+                timer.expires_at(due);
+                timer.async_wait([this](boost::system::error_code error) {
+                    if (!error) {
+                        send(due);
+                    }
+                });
+                return;
+            }
+            send(due);
+            return;
+        }
+
+        Clock::time_point now = Clock::now();
+        if (now >= stopAt) {
+            close();
+            return;
+        }
+        send(now);
+    }
+
+    Operation chooseOperation() {
+        std::discrete_distribution<int> distribution(options.mix.begin(), options.mix.end());
+        Operation chosen = static_cast<Operation>(distribution(random));
+
+        // a connection only changes items it created itself
+        if ((chosen == Put || chosen == Move || chosen == Delete) && ownItems.empty()) {
+            return Post;
+        }
+
+        return chosen;
+    }
+
+    void send(Clock::time_point requestStart) {
+        operation = chooseOperation();
+        started = requestStart;
+        sent++;
+
+        std::string title = "loadgen " + std::to_string(index) + "-" + std::to_string(sent);
+
+        if (operation == Read) {
+            request = buildRequest(options, "GET", "", "", true);
+        } else if (operation == Post) {
+            pending = OwnItem{columns[random() % columns.size()], -1, nextPosition++};
+            request = buildRequest(options, "POST", "/columns/" + std::to_string(pending.columnId) + "/items",
+                                   buildItemBody(title, pending.position), true);
+        } else {
+            std::size_t chosenItem = random() % ownItems.size();
+            OwnItem &item = ownItems[chosenItem];
+            std::string path = "/columns/" + std::to_string(item.columnId) + "/items/" + std::to_string(item.itemId);
+
+            if (operation == Delete) {
+                pending = item;
+                ownItems[chosenItem] = ownItems.back();
+                ownItems.pop_back();
+                request = buildRequest(options, "DELETE", path, "", true);
+            } else {
+                // the api has no column change for items, a move takes the item to a new position
+                if (operation == Move) {
+                    item.position = nextPosition++;
+                }
+                request = buildRequest(options, "PUT", path, buildItemBody(title, item.position), true);
+            }
+        }
+
+        boost::asio::async_write(socket, boost::asio::buffer(request), [this](boost::system::error_code error, std::size_t) {
+            if (error) {
+                fail();
+                return;
+            }
+            readHead();
+        });
+    }
+
+    void readHead() {
+        boost::asio::async_read_until(socket, buffer, "\r\n\r\n", [this](boost::system::error_code error, std::size_t headBytes) {
+            if (error) {
+                fail();
+                return;
+            }
+
+            std::string head(boost::asio::buffers_begin(buffer.data()), boost::asio::buffers_begin(buffer.data()) + headBytes);
+            buffer.consume(headBytes);
+
+            status = parseHead(head, contentLength);
+            if (status < 0) {
+                fail();
+                return;
+            }
+
+            std::size_t missing = (contentLength > buffer.size()) ? contentLength - buffer.size() : 0;
+            boost::asio::async_read(socket, buffer, boost::asio::transfer_exactly(missing), [this](boost::system::error_code error, std::size_t) {
+                if (error) {
+                    fail();
+                    return;
+                }
+
+                std::string body(boost::asio::buffers_begin(buffer.data()), boost::asio::buffers_begin(buffer.data()) + contentLength);
+                buffer.consume(contentLength);
+                complete(body);
+            });
+        });
+    }
+
+    void complete(std::string const &body) {
+        Clock::time_point finished = Clock::now();
+
+        if (operation == Post && status == 201) {
+            pending.itemId = getId(body);
+            if (pending.itemId >= 0) {
+                ownItems.push_back(pending);
+            }
+        } else if (operation == Delete && (status < 200 || status >= 300)) {
+            // still there, e.g. after a 503, left for a later delete or the cleanup
+            ownItems.push_back(pending);
+        }
+
+        if (started >= measureFrom) {
+            if (status == 503) {
+                statistics.shed[operation]++;
+            } else if (status < 200 || status >= 300) {
+                statistics.failed[operation]++;
+            } else {
+                auto micros = std::chrono::duration_cast<std::chrono::microseconds>(finished - started).count();
+                statistics.latencies[operation].push_back(static_cast<std::uint32_t>(micros));
+            }
+        }
+
+        next();
+    }
+
+    void fail() {
+        statistics.connectionErrors++;
+        close();
+    }
+
+    void close() {
+        boost::system::error_code ignored;
+        socket.shutdown(Socket::shutdown_both, ignored);
+        socket.close(ignored);
+    }
+};
+
+struct Summary {
+    std::uint64_t count = 0;
+    std::uint64_t shed = 0;
+    std::uint64_t failed = 0;
+    double throughput = 0;
+    double mean = 0;
+    double p50 = 0;
+    double p99 = 0;
+    double p999 = 0;
+    double max = 0;
+};
+
+// latencies in milliseconds, nearest rank percentiles
+Summary summarize(std::vector<std::uint32_t> latencies, std::uint64_t shed, std::uint64_t failed, double seconds) {
+    Summary summary;
+    summary.count = latencies.size();
+    summary.shed = shed;
+    summary.failed = failed;
+    summary.throughput = summary.count / seconds;
+
+    if (latencies.empty()) {
+        return summary;
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&latencies](double p) {
+        std::size_t rank = static_cast<std::size_t>(std::ceil(p * latencies.size()));
+        return latencies[std::max<std::size_t>(rank, 1) - 1] / 1000.0;
+    };
+
+    double total = 0;
+    for (auto latency : latencies)
+        total += latency;
+
+    summary.mean = total / latencies.size() / 1000.0;
+    summary.p50 = percentile(0.5);
+    summary.p99 = percentile(0.99);
+    summary.p999 = percentile(0.999);
+    summary.max = latencies.back() / 1000.0;
+
+    return summary;
+}
+
+void printSummary(char const *name, Summary const &summary) {
+    std::printf("%-8s %10llu %8llu %8llu %12.1f %9.3f %9.3f %9.3f %9.3f %9.3f\n", name,
+                static_cast<unsigned long long>(summary.count), static_cast<unsigned long long>(summary.shed),
+                static_cast<unsigned long long>(summary.failed), summary.throughput, summary.mean, summary.p50,
+                summary.p99, summary.p999, summary.max);
+}
+
+template <typename Writer>
+void writeSummary(Writer &writer, Summary const &summary) {
+    writer.StartObject();
+    writer.Key("count");
+    writer.Uint64(summary.count);
+    writer.Key("shed");
+    writer.Uint64(summary.shed);
+    writer.Key("failed");
+    writer.Uint64(summary.failed);
+    writer.Key("throughput");
+    writer.Double(summary.throughput);
+    writer.Key("meanMs");
+    writer.Double(summary.mean);
+    writer.Key("p50Ms");
+    writer.Double(summary.p50);
+    writer.Key("p99Ms");
+    writer.Double(summary.p99);
+    writer.Key("p999Ms");
+    writer.Double(summary.p999);
+    writer.Key("maxMs");
+    writer.Double(summary.max);
+    writer.EndObject();
+}
+
+void printUsage() {
+    std::cerr << "usage: LoadGenerator [options]\n"
+                 "  --host <host>           service host (127.0.0.1)\n"
+                 "  --port <port>           service port (8080)\n"
+#ifdef BOOST_ASIO_HAS_LOCAL_SOCKETS
+                 "  --unix-socket <path>    connect to the service's unix domain socket instead\n"
+#endif
+                 "  --board <id>            board to load, the default board if not given\n"
+                 "  --connections <n>       keep-alive connections (16)\n"
+                 "  --threads <n>           client threads (1)\n"
+                 "  --duration <seconds>    measured time (10)\n"
+                 "  --warmup <seconds>      time before measuring (2)\n"
+                 "  --rate <requests/s>     fixed request rate over all connections, 0 = closed loop (0)\n"
+                 "  --mix r,po,pu,m,d       weights of read, post, put, move, delete (60,15,10,5,10)\n"
+                 "  --seed <n>              seed of the request mix (1)\n"
+                 "  --json <file>           also write the results as json, - for stdout\n"
+                 "  --keep-items            do not delete the items created by the run\n";
+}
+
+bool parseOptions(int argc, char **argv, Options &options) {
+    for (int i = 1; i < argc; i++) {
+        std::string name = argv[i];
+        if (name == "--keep-items") {
+            options.cleanup = false;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            return false;
+        }
+
+        std::string value = argv[++i];
+        if (name == "--host") {
+            options.host = value;
+        } else if (name == "--port") {
+            options.port = value;
+#ifdef BOOST_ASIO_HAS_LOCAL_SOCKETS
+        } else if (name == "--unix-socket") {
+            options.unixSocket = value;
+#endif
+        } else if (name == "--board") {
+            options.board = "boards/" + value;
+        } else if (name == "--connections") {
+            options.connections = std::max(1, std::stoi(value));
+        } else if (name == "--threads") {
+            options.threads = std::max(1, std::stoi(value));
+        } else if (name == "--duration") {
+            options.duration = std::chrono::seconds(std::stoi(value));
+        } else if (name == "--warmup") {
+            options.warmup = std::chrono::seconds(std::stoi(value));
+        } else if (name == "--rate") {
+            options.rate = std::stod(value);
+        } else if (name == "--mix") {
+            std::istringstream weights(value);
+            std::string weight;
+            for (int op = 0; op < OPERATION_COUNT; op++) {
+                options.mix[op] = std::getline(weights, weight, ',') ? std::stoi(weight) : 0;
+            }
+        } else if (name == "--seed") {
+            options.seed = std::stoull(value);
+        } else if (name == "--json") {
+            options.jsonFile = value;
+        } else {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+} // namespace
+
+// Drives a running Service over keep-alive connections with a mix of board
+// reads and item posts, puts, moves and deletes, and reports throughput and
+// latency percentiles per operation.
+int main(int argc, char **argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage();
+        return 2;
+    }
+
+    boost::asio::io_service io;
+    Endpoints endpoints;
+    std::vector<std::int64_t> columns;
+    std::string target = options.unixSocket.empty() ? options.host + ":" + options.port : options.unixSocket;
+
+    try {
+#ifdef BOOST_ASIO_HAS_LOCAL_SOCKETS
+        if (!options.unixSocket.empty()) {
+            endpoints.emplace_back(boost::asio::local::stream_protocol::endpoint(options.unixSocket));
+        }
+#endif
+        if (options.unixSocket.empty()) {
+            for (auto const &entry : tcp::resolver(io).resolve(options.host, options.port)) {
+                endpoints.emplace_back(entry.endpoint());
+            }
+        }
+
+        Response response = fetch(io, endpoints, buildRequest(options, "GET", "/columns", "", false));
+        rapidjson::Document document;
+        document.Parse(response.body.c_str());
+        if (response.status == 200 && document.IsArray()) {
+            for (auto const &column : document.GetArray()) {
+                if (column.IsObject() && column.HasMember("id") && column["id"].IsInt64()) {
+                    columns.push_back(column["id"].GetInt64());
+                }
+            }
+        }
+
+        if (columns.empty()) {
+            response = fetch(io, endpoints, buildRequest(options, "POST", "/columns", "{\"name\":\"loadgen\",\"position\":1000000}", false));
+            if (getId(response.body) >= 0) {
+                columns.push_back(getId(response.body));
+            }
+        }
+    } catch (std::exception const &e) {
+        std::cerr << "cannot reach " << target << ": " << e.what() << std::endl;
+        return 1;
+    }
+
+    if (columns.empty()) {
+        std::cerr << "board has no columns and none could be created" << std::endl;
+        return 1;
+    }
+
+    Clock::time_point measureFrom = Clock::now() + options.warmup;
+    Clock::time_point stopAt = measureFrom + options.duration;
+
+    std::vector<std::unique_ptr<Connection>> connections;
+    for (int i = 0; i < options.connections; i++) {
+        connections.push_back(std::make_unique<Connection>(io, options, i, columns, measureFrom, stopAt));
+        connections.back()->start(endpoints);
+    }
+
+    std::vector<std::thread> threads;
+    for (int i = 1; i < options.threads; i++) {
+        threads.emplace_back([&io]() { io.run(); });
+    }
+    io.run();
+    for (auto &thread : threads)
+        thread.join();
+
+    Statistics total;
+    std::vector<OwnItem> leftovers;
+    for (auto const &connection : connections) {
+        total.merge(connection->getStatistics());
+        leftovers.insert(leftovers.end(), connection->getOwnItems().begin(), connection->getOwnItems().end());
+    }
+
+    if (options.cleanup) {
+        for (auto const &item : leftovers) {
+            try {
+                fetch(io, endpoints, buildRequest(options, "DELETE", "/columns/" + std::to_string(item.columnId) + "/items/" + std::to_string(item.itemId), "", false));
+            } catch (std::exception const &) {
+                break;
+            }
+        }
+    }
+
+    double seconds = std::chrono::duration<double>(options.duration).count();
+    std::array<Summary, OPERATION_COUNT> summaries;
+    std::vector<std::uint32_t> all;
+    std::uint64_t shed = 0;
+    std::uint64_t failed = 0;
+    for (int op = 0; op < OPERATION_COUNT; op++) {
+        summaries[op] = summarize(total.latencies[op], total.shed[op], total.failed[op], seconds);
+        all.insert(all.end(), total.latencies[op].begin(), total.latencies[op].end());
+        shed += total.shed[op];
+        failed += total.failed[op];
+    }
+    Summary overall = summarize(std::move(all), shed, failed, seconds);
+
+    std::printf("%s, %d connections, %d threads, %.0f s measured after %lld s warmup, %s\n", target.c_str(), options.connections,
+                options.threads, seconds, static_cast<long long>(options.warmup.count()), options.rate > 0 ? ("rate " + std::to_string(options.rate) + "/s").c_str() : "closed loop");
+    std::printf("%-8s %10s %8s %8s %12s %9s %9s %9s %9s %9s\n", "op", "ok", "shed", "failed", "requests/s", "mean ms", "p50 ms", "p99 ms",
+                "p99.9 ms", "max ms");
+    for (int op = 0; op < OPERATION_COUNT; op++) {
+        printSummary(OPERATION_NAMES[op], summaries[op]);
+    }
+    printSummary("all", overall);
+    if (total.connectionErrors > 0) {
+        std::printf("connection errors: %llu\n", static_cast<unsigned long long>(total.connectionErrors));
+    }
+
+    if (!options.jsonFile.empty()) {
+        rapidjson::StringBuffer buffer;
+        rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(buffer);
+
+        writer.StartObject();
+        writer.Key("connections");
+        writer.Int(options.connections);
+        writer.Key("threads");
+        writer.Int(options.threads);
+        writer.Key("durationSeconds");
+        writer.Double(seconds);
+        writer.Key("rate");
+        writer.Double(options.rate);
+        writer.Key("connectionErrors");
+        writer.Uint64(total.connectionErrors);
+        writer.Key("operations");
+        writer.StartObject();
+        for (int op = 0; op < OPERATION_COUNT; op++) {
+            writer.Key(OPERATION_NAMES[op]);
+            writeSummary(writer, summaries[op]);
+        }
+        writer.EndObject();
+        writer.Key("all");
+        writeSummary(writer, overall);
+        writer.EndObject();
+
+        if (options.jsonFile == "-") {
+            std::cout << buffer.GetString() << std::endl;
+        } else {
+            std::ofstream(options.jsonFile) << buffer.GetString() << std::endl;
+        }
+    }
+
+    return (total.connectionErrors > 0 || failed > 0) ? 1 : 0;
+}
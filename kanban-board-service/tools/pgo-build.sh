@@ -0,0 +1,70 @@
+#!/bin/bash
+# Builds a profile guided (and by default link time) optimized Service:
+#   1. LoadGenerator and DatasetGenerator in a plain release build
+#   2. an instrumented Service (KANBAN_PGO=GENERATE)
+#   3. a training run of LoadGenerator against it on a generated board
+#   4. the optimized Service with the profiles (KANBAN_PGO=USE)
+# usage: tools/pgo-build.sh [build directory]
+# the training service listens on KANBAN_PGO_PORT (8080), it must be free
+
+set -e
+
+sourceDir=$(dirname "$(readlink -f "$0")")/..
+buildDir=$(readlink -f "${1:-$sourceDir/build-pgo}")
+toolsDir=$buildDir/tools
+serviceDir=$buildDir/service
+profileDir=$buildDir/profiles
+trainingDir=$buildDir/training
+
+lto=${KANBAN_PGO_LTO:-ON}
+trainingItems=${KANBAN_PGO_TRAINING_ITEMS:-2000}
+trainingSeconds=${KANBAN_PGO_TRAINING_SECONDS:-20}
+jobs=${KANBAN_PGO_JOBS:-$(nproc)}
+port=${KANBAN_PGO_PORT:-8080}
+
+echo "building the training tools in $toolsDir"
+cmake -S "$sourceDir" -B "$toolsDir" -DCMAKE_BUILD_TYPE=Release -DKANBAN_BUILD_TOOLS=ON > /dev/null
+cmake --build "$toolsDir" --target LoadGenerator DatasetGenerator -- -j "$jobs" > /dev/null
+
+echo "building the instrumented service in $serviceDir"
+rm -rf "$profileDir"
+mkdir -p "$profileDir"
+cmake -S "$sourceDir" -B "$serviceDir" -DCMAKE_BUILD_TYPE=Release -DKANBAN_LTO="$lto" -DKANBAN_PGO=GENERATE \
+    -DKANBAN_PGO_DIR="$profileDir" > /dev/null
+cmake --build "$serviceDir" --target Service -- -j "$jobs" > /dev/null
+
+# the release service keeps its boards in ./data below the working directory
+echo "training on $trainingItems items for $trainingSeconds seconds"
+rm -rf "$trainingDir"
+mkdir -p "$trainingDir/data"
+"$toolsDir/DatasetGenerator" --output "$trainingDir/data/kanban-board.db" --items "$trainingItems" > /dev/null
+
+(cd "$trainingDir" && KANBAN_PORT=$port exec "$serviceDir/Service" > service.log 2>&1) &
+servicePid=$!
+trap 'kill $servicePid 2> /dev/null || true' EXIT
+
+for attempt in $(seq 50); do
+    if (exec 3<> /dev/tcp/127.0.0.1/$port) 2> /dev/null; then
+        break
+    fi
+    sleep 0.2
+done
+
+# the standard mix first, then a write heavy one so the write paths get their share of the profile
+"$toolsDir/LoadGenerator" --port "$port" --connections 8 --duration "$trainingSeconds" --warmup 1
+"$toolsDir/LoadGenerator" --port "$port" --connections 8 --duration $((trainingSeconds / 2)) --warmup 0 --mix 20,30,30,10,10 --seed 2
+
+# the profiles are written when the service exits
+kill -INT $servicePid
+wait $servicePid || true
+trap - EXIT
+
+if ls "$profileDir"/*.profraw > /dev/null 2>&1; then
+    llvm-profdata merge -output="$profileDir/service.profdata" "$profileDir"/*.profraw
+fi
+
+echo "building the optimized service"
+cmake -S "$sourceDir" -B "$serviceDir" -DKANBAN_PGO=USE > /dev/null
+cmake --build "$serviceDir" --target Service -- -j "$jobs" > /dev/null
+
+echo "done: $serviceDir/Service"